@@ -0,0 +1,904 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <memory>
+#include <type_traits>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+/*
+Аллокаторы для Vector<T, Alloc> и RawMemory<T, Alloc>, позволяющие не ходить
+в общую кучу при каждом росте вектора.
+
+MonotonicArena — монотонный арена-буфер: память выдаётся сдвигом указателя
+внутри крупных блоков и никогда не возвращается поштучно. Вся память арены
+освобождается разом вызовом Release() или в деструкторе. Подходит для
+векторов, живущих в пределах одного запроса.
+
+PoolResource — пул блоков фиксированных классов размеров (степени двойки от
+MIN_CLASS_SIZE до MAX_CLASS_SIZE байт). Освобождённый блок возвращается в
+список свободных блоков своего класса и переиспользуется следующим запросом
+того же класса. Запросы больше MAX_CLASS_SIZE уходят в глобальный operator new.
+
+Оба ресурса умеют расширять блок на месте (TryExpand): арена — если блок
+выделен последним и в текущем куске есть место, пул — если новый размер
+помещается в тот же класс. Vector пользуется этим через try_expand аллокатора.
+
+Оба ресурса не потокобезопасны: предполагается, что каждый поток (запрос)
+владеет собственным ресурсом. Ресурс должен пережить все контейнеры, которые
+им пользуются. Аллокаторы ArenaAllocator<T> и PoolAllocator<T> лишь ссылаются
+на ресурс и равны, если ссылаются на один и тот же ресурс. Как и аллокаторы
+std::pmr, они не передаются при копировании, перемещении и обмене контейнеров.
+
+MallocAllocator — аллокатор поверх malloc/free с realloc-подобной операцией
+reallocate. Для тривиально перемещаемых элементов Vector растёт через realloc,
+который для больших блоков обычно переотображает страницы вместо копирования.
+
+AlignedAllocator<T, ALIGNMENT> выделяет память через operator new(size, align_val_t)
+с выравниванием ALIGNMENT (например, 32 или 64 байта для загрузок AVX) и объявляет
+его в Alloc::alignment, так что Vector позволяет компилятору на него рассчитывать.
+
+HugePageAllocator<T> для буферов от LARGE_BUFFER_SIZE байт использует mmap с
+выравниванием на огромную страницу и MADV_HUGEPAGE, что снижает нагрузку на TLB,
+а при росте тривиально перемещаемых элементов переотображает буфер через mremap.
+Меньшие буферы выделяются как в AlignedAllocator с выравниванием на кэш-линию.
+Вне Linux все буферы выделяются обычным выровненным operator new.
+
+AccountingAllocator<T, Base> учитывает память векторов на счёте VectorMemoryAccount
+(например, отдельном для каждого арендатора) и не даёт превысить его лимит.
+*/
+
+class MonotonicArena
+{
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 4096;
+
+    explicit MonotonicArena(size_t initial_block_size = DEFAULT_BLOCK_SIZE) noexcept
+        : next_block_size_(initial_block_size != 0 ? initial_block_size : DEFAULT_BLOCK_SIZE)
+    {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena()
+    {
+        Release();
+    }
+
+    // Выделяет bytes байт с выравниванием alignment. Бросает std::bad_alloc,
+    // если новый блок получить не удалось
+    void* Allocate(size_t bytes, size_t alignment)
+    {
+        assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+        if (void* result = TryAllocateFromCurrent(bytes, alignment))
+        {
+            return result;
+        }
+        if (bytes > MAX_PAYLOAD - alignment)
+        {
+            throw std::bad_alloc();
+        }
+        AddBlock(bytes + alignment);
+        void* result = TryAllocateFromCurrent(bytes, alignment);
+        assert(result != nullptr);
+        return result;
+    }
+
+    // Расширяет блок ptr размером old_bytes до new_bytes, если он выделен последним
+    // и в текущем куске достаточно места
+    bool TryExpand(void* ptr, size_t old_bytes, size_t new_bytes, size_t /*alignment*/) noexcept
+    {
+        char* block_end = static_cast<char*>(ptr) + old_bytes;
+        if (block_end != current_ || new_bytes < old_bytes
+            || new_bytes - old_bytes > static_cast<size_t>(end_ - current_))
+        {
+            return false;
+        }
+        current_ += new_bytes - old_bytes;
+        return true;
+    }
+
+    // Монотонная арена не освобождает память поштучно
+    void Deallocate(void* /*ptr*/, size_t /*bytes*/, size_t /*alignment*/) noexcept
+    {}
+
+    // Освобождает все блоки арены разом. Все указатели, выданные ранее, становятся недействительными
+    void Release() noexcept
+    {
+        while (head_ != nullptr)
+        {
+            Block* next = head_->next;
+            operator delete(head_);
+            head_ = next;
+        }
+        current_ = nullptr;
+        end_ = nullptr;
+    }
+
+    // Количество байт, выделенных ареной у глобального operator new
+    size_t BytesReserved() const noexcept
+    {
+        return bytes_reserved_;
+    }
+
+private:
+    struct Block
+    {
+        Block* next;
+        size_t size;
+    };
+
+    // Наибольший размер полезной части блока, при котором размер блока помещается в size_t
+    static constexpr size_t MAX_PAYLOAD = static_cast<size_t>(-1) - sizeof(Block);
+
+    void* TryAllocateFromCurrent(size_t bytes, size_t alignment) noexcept
+    {
+        if (current_ == nullptr)
+        {
+            return nullptr;
+        }
+        void* ptr = current_;
+        size_t space = static_cast<size_t>(end_ - current_);
+        if (std::align(alignment, bytes, ptr, space) == nullptr)
+        {
+            return nullptr;
+        }
+        current_ = static_cast<char*>(ptr) + bytes;
+        return ptr;
+    }
+
+    void AddBlock(size_t min_payload)
+    {
+        // Размер блоков растёт геометрически, чтобы число блоков было логарифмическим
+        // Удвоение не должно переполнить size_t: тогда берём ровно min_payload
+        size_t payload = next_block_size_;
+        while (payload < min_payload)
+        {
+            payload = payload <= MAX_PAYLOAD / 2 ? payload * 2 : min_payload;
+        }
+        const size_t block_size = sizeof(Block) + payload;
+        Block* block = static_cast<Block*>(operator new(block_size));
+        block->next = head_;
+        block->size = block_size;
+        head_ = block;
+        current_ = reinterpret_cast<char*>(block + 1);
+        end_ = reinterpret_cast<char*>(block) + block_size;
+        bytes_reserved_ += block_size;
+        next_block_size_ = payload <= MAX_PAYLOAD / 2 ? payload * 2 : MAX_PAYLOAD;
+    }
+
+    Block* head_ = nullptr;
+    char* current_ = nullptr;
+    char* end_ = nullptr;
+    size_t next_block_size_;
+    size_t bytes_reserved_ = 0;
+};
+
+
+class PoolResource
+{
+public:
+    static constexpr size_t MIN_CLASS_SIZE = 16;
+    static constexpr size_t MAX_CLASS_SIZE = 4096;
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    PoolResource() = default;
+
+    PoolResource(const PoolResource&) = delete;
+    PoolResource& operator=(const PoolResource&) = delete;
+
+    ~PoolResource()
+    {
+        Release();
+    }
+
+    void* Allocate(size_t bytes, size_t alignment)
+    {
+        if (!IsPooled(bytes, alignment))
+        {
+            return operator new(bytes, std::align_val_t{ alignment });
+        }
+        const size_t class_index = ClassIndex(bytes);
+        FreeBlock*& free_list = free_lists_[class_index];
+        if (free_list == nullptr)
+        {
+            Refill(class_index);
+        }
+        FreeBlock* block = free_list;
+        free_list = block->next;
+        return block;
+    }
+
+    void Deallocate(void* ptr, size_t bytes, size_t alignment) noexcept
+    {
+        if (!IsPooled(bytes, alignment))
+        {
+            operator delete(ptr, std::align_val_t{ alignment });
+            return;
+        }
+        FreeBlock*& free_list = free_lists_[ClassIndex(bytes)];
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->next = free_list;
+        free_list = block;
+    }
+
+    // Блок пула можно расширить на месте, пока новый размер помещается в его класс
+    bool TryExpand(void* /*ptr*/, size_t old_bytes, size_t new_bytes, size_t alignment) noexcept
+    {
+        return IsPooled(old_bytes, alignment) && new_bytes <= RoundUpToClass(old_bytes);
+    }
+
+    // Освобождает все куски пула разом. Блоки больше MAX_CLASS_SIZE
+    // освобождаются их владельцами через Deallocate
+    void Release() noexcept
+    {
+        while (chunks_ != nullptr)
+        {
+            Chunk* next = chunks_->next;
+            operator delete(chunks_);
+            chunks_ = next;
+        }
+        for (FreeBlock*& free_list : free_lists_)
+        {
+            free_list = nullptr;
+        }
+    }
+
+    // Размер блока, который фактически будет выдан на запрос bytes байт
+    static constexpr size_t RoundUpToClass(size_t bytes) noexcept
+    {
+        if (bytes > MAX_CLASS_SIZE)
+        {
+            return bytes;
+        }
+        size_t class_size = MIN_CLASS_SIZE;
+        while (class_size < bytes)
+        {
+            class_size *= 2;
+        }
+        return class_size;
+    }
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct alignas(std::max_align_t) Chunk
+    {
+        Chunk* next;
+    };
+
+    static constexpr size_t CLASS_COUNT = 9;  // 16, 32, ..., 4096
+    static_assert((MIN_CLASS_SIZE << (CLASS_COUNT - 1)) == MAX_CLASS_SIZE);
+    static_assert(MIN_CLASS_SIZE >= sizeof(FreeBlock));
+
+    static constexpr bool IsPooled(size_t bytes, size_t alignment) noexcept
+    {
+        return bytes <= MAX_CLASS_SIZE && alignment <= alignof(std::max_align_t);
+    }
+
+    static constexpr size_t ClassIndex(size_t bytes) noexcept
+    {
+        size_t index = 0;
+        for (size_t class_size = MIN_CLASS_SIZE; class_size < bytes; class_size *= 2)
+        {
+            ++index;
+        }
+        return index;
+    }
+
+    // Нарезает новый кусок на блоки класса class_index и складывает их в список свободных
+    void Refill(size_t class_index)
+    {
+        const size_t class_size = MIN_CLASS_SIZE << class_index;
+        Chunk* chunk = static_cast<Chunk*>(operator new(sizeof(Chunk) + CHUNK_SIZE));
+        chunk->next = chunks_;
+        chunks_ = chunk;
+
+        char* first = reinterpret_cast<char*>(chunk + 1);
+        FreeBlock*& free_list = free_lists_[class_index];
+        for (size_t i = CHUNK_SIZE / class_size; i > 0; --i)
+        {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(first + (i - 1) * class_size);
+            block->next = free_list;
+            free_list = block;
+        }
+    }
+
+    Chunk* chunks_ = nullptr;
+    FreeBlock* free_lists_[CLASS_COUNT] = {};
+};
+
+
+// Общая часть аллокаторов, ссылающихся на ресурс Resource
+template <typename T, typename Resource>
+class ResourceAllocator
+{
+public:
+    using value_type = T;
+
+    explicit ResourceAllocator(Resource& resource) noexcept
+        : resource_(&resource)
+    {}
+
+    template <typename U>
+    ResourceAllocator(const ResourceAllocator<U, Resource>& other) noexcept
+        : resource_(other.GetResource())
+    {}
+
+    T* allocate(size_t n)
+    {
+        if (n > static_cast<size_t>(-1) / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(resource_->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept
+    {
+        resource_->Deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    bool try_expand(T* ptr, size_t old_n, size_t new_n) noexcept
+    {
+        if (new_n > static_cast<size_t>(-1) / sizeof(T))
+        {
+            return false;
+        }
+        return resource_->TryExpand(ptr, old_n * sizeof(T), new_n * sizeof(T), alignof(T));
+    }
+
+    Resource* GetResource() const noexcept
+    {
+        return resource_;
+    }
+
+    template <typename U>
+    bool operator==(const ResourceAllocator<U, Resource>& other) const noexcept
+    {
+        return resource_ == other.GetResource();
+    }
+
+    template <typename U>
+    bool operator!=(const ResourceAllocator<U, Resource>& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+    Resource* resource_;
+};
+
+template <typename T>
+class ArenaAllocator : public ResourceAllocator<T, MonotonicArena>
+{
+public:
+    using ResourceAllocator<T, MonotonicArena>::ResourceAllocator;
+};
+
+template <typename T>
+class PoolAllocator : public ResourceAllocator<T, PoolResource>
+{
+public:
+    using ResourceAllocator<T, PoolResource>::ResourceAllocator;
+
+    // Размер блока, который пул фактически выдаст на запрос bytes байт (для SizeClassGrowth)
+    static constexpr size_t good_size(size_t bytes) noexcept
+    {
+        return PoolResource::RoundUpToClass(bytes);
+    }
+};
+
+
+template <typename T>
+class MallocAllocator
+{
+public:
+    using value_type = T;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc can not provide extended alignment");
+
+    MallocAllocator() = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>& /*other*/) noexcept
+    {}
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(CheckResult(n, std::malloc(CheckedBytes(n))));
+    }
+
+    void deallocate(T* ptr, size_t /*n*/) noexcept
+    {
+        std::free(ptr);
+    }
+
+    // При неудаче бросает std::bad_alloc, блок ptr остаётся действительным
+    T* reallocate(T* ptr, size_t /*old_n*/, size_t new_n)
+    {
+        return static_cast<T*>(CheckResult(new_n, std::realloc(static_cast<void*>(ptr), CheckedBytes(new_n))));
+    }
+
+    template <typename U>
+    bool operator==(const MallocAllocator<U>& /*other*/) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const MallocAllocator<U>& /*other*/) const noexcept
+    {
+        return false;
+    }
+
+private:
+    static size_t CheckedBytes(size_t n)
+    {
+        if (n > static_cast<size_t>(-1) / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+
+    static void* CheckResult(size_t n, void* result)
+    {
+        if (result == nullptr && n != 0)
+        {
+            throw std::bad_alloc();
+        }
+        return result;
+    }
+};
+
+
+template <typename T, size_t ALIGNMENT>
+class AlignedAllocator
+{
+public:
+    using value_type = T;
+
+    static constexpr size_t alignment = std::max(ALIGNMENT, alignof(T));
+    static_assert((alignment & (alignment - 1)) == 0, "alignment must be a power of two");
+
+    template <typename U>
+    struct rebind
+    {
+        using other = AlignedAllocator<U, ALIGNMENT>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, ALIGNMENT>& /*other*/) noexcept
+    {}
+
+    T* allocate(size_t n)
+    {
+        if (n > static_cast<size_t>(-1) / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(operator new(n * sizeof(T), std::align_val_t{ alignment }));
+    }
+
+    void deallocate(T* ptr, size_t /*n*/) noexcept
+    {
+        operator delete(ptr, std::align_val_t{ alignment });
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, ALIGNMENT>& /*other*/) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, ALIGNMENT>& /*other*/) const noexcept
+    {
+        return false;
+    }
+};
+
+
+template <typename T>
+class HugePageAllocator
+{
+public:
+    using value_type = T;
+
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+    static constexpr size_t LARGE_BUFFER_SIZE = HUGE_PAGE_SIZE;
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t alignment = std::max(CACHE_LINE_SIZE, alignof(T));
+
+    HugePageAllocator() = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>& /*other*/) noexcept
+    {}
+
+    T* allocate(size_t n)
+    {
+        const size_t bytes = CheckedBytes(n);
+        if (IsLarge(bytes))
+        {
+            return static_cast<T*>(MapLarge(bytes));
+        }
+        return static_cast<T*>(operator new(bytes, std::align_val_t{ alignment }));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept
+    {
+        const size_t bytes = n * sizeof(T);
+        if (IsLarge(bytes))
+        {
+            UnmapLarge(ptr, bytes);
+            return;
+        }
+        operator delete(ptr, std::align_val_t{ alignment });
+    }
+
+    // Используется Vector только для тривиально перемещаемых T: содержимое переносится побайтово
+    T* reallocate(T* ptr, size_t old_n, size_t new_n)
+    {
+        const size_t old_bytes = old_n * sizeof(T);
+        const size_t new_bytes = CheckedBytes(new_n);
+#if defined(__linux__)
+        if (IsLarge(old_bytes) && IsLarge(new_bytes))
+        {
+            void* result = mremap(static_cast<void*>(ptr), RoundUpToHugePage(old_bytes),
+                                  RoundUpToHugePage(new_bytes), MREMAP_MAYMOVE);
+            if (result == MAP_FAILED)
+            {
+                throw std::bad_alloc();
+            }
+            madvise(result, RoundUpToHugePage(new_bytes), MADV_HUGEPAGE);
+            return static_cast<T*>(result);
+        }
+#endif
+        T* result = allocate(new_n);
+        std::memcpy(static_cast<void*>(result), static_cast<const void*>(ptr), std::min(old_bytes, new_bytes));
+        deallocate(ptr, old_n);
+        return result;
+    }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U>& /*other*/) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U>& /*other*/) const noexcept
+    {
+        return false;
+    }
+
+private:
+    static size_t CheckedBytes(size_t n)
+    {
+        if (n > (static_cast<size_t>(-1) - HUGE_PAGE_SIZE) / 2 / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+
+    static constexpr bool IsLarge(size_t bytes) noexcept
+    {
+#if defined(__linux__)
+        return bytes >= LARGE_BUFFER_SIZE;
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+
+    static constexpr size_t RoundUpToHugePage(size_t bytes) noexcept
+    {
+        return (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    }
+
+    static void* MapLarge(size_t bytes)
+    {
+#if defined(__linux__)
+        // Отображаем с запасом в одну огромную страницу и обрезаем края,
+        // чтобы начало буфера было выровнено на HUGE_PAGE_SIZE
+        const size_t size = RoundUpToHugePage(bytes);
+        const size_t mapped_size = size + HUGE_PAGE_SIZE;
+        void* mapped = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapped == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+        char* begin = static_cast<char*>(mapped);
+        char* aligned = reinterpret_cast<char*>(
+            (reinterpret_cast<uintptr_t>(begin) + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE);
+        if (aligned != begin)
+        {
+            munmap(begin, static_cast<size_t>(aligned - begin));
+        }
+        char* end = aligned + size;
+        const size_t tail = static_cast<size_t>(begin + mapped_size - end);
+        if (tail != 0)
+        {
+            munmap(end, tail);
+        }
+        madvise(aligned, size, MADV_HUGEPAGE);
+        return aligned;
+#else
+        (void)bytes;
+        return nullptr;
+#endif
+    }
+
+    static void UnmapLarge(void* ptr, size_t bytes) noexcept
+    {
+#if defined(__linux__)
+        munmap(ptr, RoundUpToHugePage(bytes));
+#else
+        (void)ptr;
+        (void)bytes;
+#endif
+    }
+};
+
+
+/*
+VectorMemoryAccount — счёт живых байт, выделенных через AccountingAllocator,
+с необязательным лимитом. Счёт потокобезопасен: им могут одновременно пользоваться
+векторы из разных потоков. Счёт должен пережить все контейнеры, которые им пользуются.
+
+AccountingAllocator<T, Base> выделяет память аллокатором Base, предварительно
+списывая размер буфера со счёта. Если лимит был бы превышен, allocate бросает
+VectorBudgetExceeded (наследник std::bad_alloc), не обращаясь к Base, а try_allocate
+возвращает nullptr, и Vector::TryReserve просто возвращает false. try_expand
+и reallocate аллокатора Base доступны и тоже проходят через счёт.
+Аллокаторы равны, если ссылаются на один счёт и их Base равны. Как и ArenaAllocator,
+они не передаются при перемещении и обмене контейнеров, поэтому память вектора
+всегда учитывается на том счёте, которым была выделена.
+*/
+class VectorBudgetExceeded : public std::bad_alloc
+{
+public:
+    const char* what() const noexcept override
+    {
+        return "VectorMemoryAccount: memory budget exceeded";
+    }
+};
+
+class VectorMemoryAccount
+{
+public:
+    static constexpr size_t UNLIMITED = static_cast<size_t>(-1);
+
+    explicit VectorMemoryAccount(size_t limit = UNLIMITED) noexcept
+        : limit_(limit)
+    {}
+
+    // Векторы ссылаются на счёт по адресу
+    VectorMemoryAccount(const VectorMemoryAccount&) = delete;
+    VectorMemoryAccount& operator=(const VectorMemoryAccount&) = delete;
+
+    // Списывает bytes, если живых байт после этого будет не больше лимита
+    bool TryCharge(size_t bytes) noexcept
+    {
+        const size_t limit = limit_.load(std::memory_order_relaxed);
+        size_t live = live_.load(std::memory_order_relaxed);
+        do
+        {
+            if (bytes > limit || live > limit - bytes)
+            {
+                return false;
+            }
+        } while (!live_.compare_exchange_weak(live, live + bytes, std::memory_order_relaxed));
+        UpdatePeak(live + bytes);
+        return true;
+    }
+
+    void Refund(size_t bytes) noexcept
+    {
+        [[maybe_unused]] const size_t live = live_.fetch_sub(bytes, std::memory_order_relaxed);
+        assert(live >= bytes);
+    }
+
+    size_t LiveBytes() const noexcept
+    {
+        return live_.load(std::memory_order_relaxed);
+    }
+
+    size_t PeakBytes() const noexcept
+    {
+        return peak_.load(std::memory_order_relaxed);
+    }
+
+    size_t Limit() const noexcept
+    {
+        return limit_.load(std::memory_order_relaxed);
+    }
+
+    // Лимит ниже текущего объёма не освобождает память, а лишь запрещает дальнейший рост
+    void SetLimit(size_t limit) noexcept
+    {
+        limit_.store(limit, std::memory_order_relaxed);
+    }
+
+private:
+    void UpdatePeak(size_t live) noexcept
+    {
+        size_t peak = peak_.load(std::memory_order_relaxed);
+        while (peak < live && !peak_.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    std::atomic<size_t> live_{ 0 };
+    std::atomic<size_t> peak_{ 0 };
+    std::atomic<size_t> limit_;
+};
+
+template <typename T, typename Base = std::allocator<T>>
+class AccountingAllocator
+{
+    using BaseTraits = std::allocator_traits<Base>;
+
+    static_assert(std::is_same_v<typename BaseTraits::value_type, T>, "Base::value_type must be the same as T");
+
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = AccountingAllocator<U, typename BaseTraits::template rebind_alloc<U>>;
+    };
+
+    explicit AccountingAllocator(VectorMemoryAccount& account, const Base& base = Base()) noexcept
+        : account_(&account)
+        , base_(base)
+    {}
+
+    template <typename U, typename OtherBase>
+    AccountingAllocator(const AccountingAllocator<U, OtherBase>& other) noexcept
+        : account_(&other.GetAccount())
+        , base_(other.GetBase())
+    {}
+
+    T* allocate(size_t n)
+    {
+        const size_t bytes = CheckedBytes(n);
+        if (!account_->TryCharge(bytes))
+        {
+            throw VectorBudgetExceeded();
+        }
+        try
+        {
+            return BaseTraits::allocate(base_, n);
+        }
+        catch (...)
+        {
+            account_->Refund(bytes);
+            throw;
+        }
+    }
+
+    T* try_allocate(size_t n) noexcept
+    {
+        if (n > MAX_COUNT || !account_->TryCharge(n * sizeof(T)))
+        {
+            return nullptr;
+        }
+        try
+        {
+            return BaseTraits::allocate(base_, n);
+        }
+        catch (...)
+        {
+            account_->Refund(n * sizeof(T));
+            return nullptr;
+        }
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept
+    {
+        BaseTraits::deallocate(base_, ptr, n);
+        account_->Refund(n * sizeof(T));
+    }
+
+    template <typename B = Base>
+    auto try_expand(T* ptr, size_t old_n, size_t new_n) noexcept
+        -> decltype(std::declval<B&>().try_expand(ptr, old_n, new_n), bool())
+    {
+        if (new_n <= old_n || new_n > MAX_COUNT || !account_->TryCharge((new_n - old_n) * sizeof(T)))
+        {
+            return false;
+        }
+        if (base_.try_expand(ptr, old_n, new_n))
+        {
+            return true;
+        }
+        account_->Refund((new_n - old_n) * sizeof(T));
+        return false;
+    }
+
+    template <typename B = Base>
+    auto reallocate(T* ptr, size_t old_n, size_t new_n) -> decltype(std::declval<B&>().reallocate(ptr, old_n, new_n))
+    {
+        const size_t old_bytes = old_n * sizeof(T);
+        const size_t new_bytes = CheckedBytes(new_n);
+        if (new_bytes > old_bytes && !account_->TryCharge(new_bytes - old_bytes))
+        {
+            throw VectorBudgetExceeded();
+        }
+        T* result;
+        try
+        {
+            result = base_.reallocate(ptr, old_n, new_n);
+        }
+        catch (...)
+        {
+            if (new_bytes > old_bytes)
+            {
+                account_->Refund(new_bytes - old_bytes);
+            }
+            throw;
+        }
+        if (new_bytes < old_bytes)
+        {
+            account_->Refund(old_bytes - new_bytes);
+        }
+        return result;
+    }
+
+    VectorMemoryAccount& GetAccount() const noexcept
+    {
+        return *account_;
+    }
+
+    const Base& GetBase() const noexcept
+    {
+        return base_;
+    }
+
+    template <typename U, typename OtherBase>
+    bool operator==(const AccountingAllocator<U, OtherBase>& other) const noexcept
+    {
+        return account_ == &other.GetAccount() && base_ == other.GetBase();
+    }
+
+    template <typename U, typename OtherBase>
+    bool operator!=(const AccountingAllocator<U, OtherBase>& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+    static constexpr size_t MAX_COUNT = static_cast<size_t>(-1) / sizeof(T);
+
+    static size_t CheckedBytes(size_t n)
+    {
+        if (n > MAX_COUNT)
+        {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+
+    VectorMemoryAccount* account_;
+    Base base_;
+};
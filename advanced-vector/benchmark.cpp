@@ -0,0 +1,473 @@
+#include "vector.h"
+#include "vector_simd.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+Набор бенчмарков Google Benchmark, сравнивающий Vector и std::vector.
+
+Сборка и запуск (результаты в JSON для отслеживания регрессий в CI):
+    g++ -std=c++17 -O2 -DNDEBUG benchmark.cpp -lbenchmark -lpthread -o vector_benchmark
+    ./vector_benchmark --benchmark_format=json --benchmark_out=vector_benchmark.json
+
+Типы элементов:
+-Trivial — тривиально копируемая структура, перемещается memcpy;
+-NothrowMovable — std::string с noexcept-перемещением;
+-CopyOnly — тип без move-конструктора, при реаллокации элементы копируются.
+
+BM_PushBackCode сравнивает код, который PushBack встраивает в вызывающую функцию:
+счётчик code_bytes — размер функции-обёртки с одним вызовом PushBack (на GCC и Clang
+в Linux, где обёртки размещаются в отдельных секциях), instructions_per_push —
+число выполненных инструкций на вставку по аппаратному счётчику perf (если ядро
+разрешает perf_event_open, иначе счётчик не выводится).
+*/
+
+namespace
+{
+
+struct Trivial
+{
+    int64_t a = 0;
+    int64_t b = 0;
+};
+
+using NothrowMovable = std::string;
+
+struct CopyOnly
+{
+    CopyOnly() = default;
+    CopyOnly(const CopyOnly& other)
+        : value(other.value)
+    {}
+    CopyOnly& operator=(const CopyOnly& other)
+    {
+        value = other.value;
+        return *this;
+    }
+
+    std::string value;
+};
+
+template <typename T>
+T MakeValue(size_t i)
+{
+    if constexpr (std::is_same_v<T, Trivial>)
+    {
+        return Trivial{ static_cast<int64_t>(i), static_cast<int64_t>(i) };
+    }
+    else if constexpr (std::is_same_v<T, NothrowMovable>)
+    {
+        // Строка длиннее SSO, чтобы перемещение отличалось от копирования
+        return std::string(32, static_cast<char>('a' + i % 26));
+    }
+    else
+    {
+        CopyOnly result;
+        result.value = std::string(32, static_cast<char>('a' + i % 26));
+        return result;
+    }
+}
+
+// Адаптеры, скрывающие различия в именах методов Vector и std::vector
+
+template <typename T>
+void PushBack(std::vector<T>& v, const T& value)
+{
+    v.push_back(value);
+}
+
+template <typename T>
+void PushBack(Vector<T>& v, const T& value)
+{
+    v.PushBack(value);
+}
+
+template <typename T>
+void EmplaceBack(std::vector<T>& v)
+{
+    v.emplace_back();
+}
+
+template <typename T>
+void EmplaceBack(Vector<T>& v)
+{
+    v.EmplaceBack();
+}
+
+template <typename T>
+void Reserve(std::vector<T>& v, size_t n)
+{
+    v.reserve(n);
+}
+
+template <typename T>
+void Reserve(Vector<T>& v, size_t n)
+{
+    v.Reserve(n);
+}
+
+template <typename T>
+void InsertMiddle(std::vector<T>& v, const T& value)
+{
+    v.insert(v.begin() + v.size() / 2, value);
+}
+
+template <typename T>
+void InsertMiddle(Vector<T>& v, const T& value)
+{
+    v.Insert(v.cbegin() + v.Size() / 2, value);
+}
+
+template <typename T>
+void EraseMiddle(std::vector<T>& v)
+{
+    v.erase(v.begin() + v.size() / 2);
+}
+
+template <typename T>
+void EraseMiddle(Vector<T>& v)
+{
+    v.Erase(v.cbegin() + v.Size() / 2);
+}
+
+// Групповые операции над float: алгоритмы STL для std::vector и ядра vector_simd.h для Vector
+
+inline size_t FindValue(const std::vector<float>& v, float value)
+{
+    return static_cast<size_t>(std::find(v.begin(), v.end(), value) - v.begin());
+}
+
+inline size_t FindValue(const Vector<float>& v, float value)
+{
+    return static_cast<size_t>(Find(v, value) - v.begin());
+}
+
+inline float Sum(const std::vector<float>& v)
+{
+    return std::accumulate(v.begin(), v.end(), 0.0f);
+}
+
+inline float Sum(const Vector<float>& v)
+{
+    return Accumulate(v, 0.0f);
+}
+
+// Обёртки вставки для BM_PushBackCode. Каждая лежит в собственной секции, границы
+// которой компоновщик GNU отмечает символами __start_<секция> и __stop_<секция>
+#if defined(__linux__) && (defined(__GNUC__) || defined(__clang__))
+#define BENCHMARK_CODE_SECTION(name) [[gnu::noinline, gnu::section(name)]]
+#define BENCHMARK_HAS_CODE_SIZE 1
+
+extern "C" const char __start_bench_vector_push[];
+extern "C" const char __stop_bench_vector_push[];
+extern "C" const char __start_bench_std_vector_push[];
+extern "C" const char __stop_bench_std_vector_push[];
+#else
+#define BENCHMARK_CODE_SECTION(name) [[gnu::noinline]]
+#endif
+
+BENCHMARK_CODE_SECTION("bench_vector_push") void PushBackCode(Vector<Trivial>& v, const Trivial& value)
+{
+    v.PushBack(value);
+}
+
+BENCHMARK_CODE_SECTION("bench_std_vector_push") void PushBackCode(std::vector<Trivial>& v, const Trivial& value)
+{
+    v.push_back(value);
+}
+
+// Размер в байтах кода обёртки PushBackCode для Container, 0 — если неизвестен
+template <typename Container>
+size_t PushBackCodeBytes()
+{
+#if defined(BENCHMARK_HAS_CODE_SIZE)
+    if constexpr (std::is_same_v<Container, Vector<Trivial>>)
+    {
+        return static_cast<size_t>(__stop_bench_vector_push - __start_bench_vector_push);
+    }
+    else
+    {
+        return static_cast<size_t>(__stop_bench_std_vector_push - __start_bench_std_vector_push);
+    }
+#else
+    return 0;
+#endif
+}
+
+// Аппаратный счётчик выполненных инструкций пользовательского кода текущего потока
+class InstructionCounter
+{
+public:
+    InstructionCounter()
+    {
+#if defined(__linux__)
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    InstructionCounter(const InstructionCounter&) = delete;
+    InstructionCounter& operator=(const InstructionCounter&) = delete;
+
+    ~InstructionCounter()
+    {
+#if defined(__linux__)
+        if (fd_ >= 0)
+        {
+            close(fd_);
+        }
+#endif
+    }
+
+    bool IsAvailable() const noexcept
+    {
+        return fd_ >= 0;
+    }
+
+    void Start() noexcept
+    {
+#if defined(__linux__)
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    uint64_t Stop() noexcept
+    {
+        uint64_t count = 0;
+#if defined(__linux__)
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd_, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count)))
+        {
+            count = 0;
+        }
+#endif
+        return count;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+template <typename Container>
+Container MakeFilled(size_t n)
+{
+    using T = std::decay_t<decltype(*std::declval<Container&>().begin())>;
+    Container v;
+    Reserve(v, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        PushBack(v, MakeValue<T>(i));
+    }
+    return v;
+}
+
+template <typename Container>
+void BM_PushBack(benchmark::State& state)
+{
+    using T = std::decay_t<decltype(*std::declval<Container&>().begin())>;
+    const size_t n = static_cast<size_t>(state.range(0));
+    const T value = MakeValue<T>(0);
+    for (auto _ : state)
+    {
+        Container v;
+        for (size_t i = 0; i < n; ++i)
+        {
+            PushBack(v, value);
+        }
+        benchmark::DoNotOptimize(v.begin());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+template <typename Container>
+void BM_EmplaceBack(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        Container v;
+        for (size_t i = 0; i < n; ++i)
+        {
+            EmplaceBack(v);
+        }
+        benchmark::DoNotOptimize(v.begin());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+template <typename Container>
+void BM_ReserveFill(benchmark::State& state)
+{
+    using T = std::decay_t<decltype(*std::declval<Container&>().begin())>;
+    const size_t n = static_cast<size_t>(state.range(0));
+    const T value = MakeValue<T>(0);
+    for (auto _ : state)
+    {
+        Container v;
+        Reserve(v, n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            PushBack(v, value);
+        }
+        benchmark::DoNotOptimize(v.begin());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+template <typename Container>
+void BM_InsertEraseMiddle(benchmark::State& state)
+{
+    using T = std::decay_t<decltype(*std::declval<Container&>().begin())>;
+    const size_t n = static_cast<size_t>(state.range(0));
+    Container v = MakeFilled<Container>(n);
+    const T value = MakeValue<T>(n);
+    for (auto _ : state)
+    {
+        InsertMiddle(v, value);
+        EraseMiddle(v);
+        benchmark::DoNotOptimize(v.begin());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 2));
+}
+
+template <typename Container>
+void BM_CopyAssign(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const Container source = MakeFilled<Container>(n);
+    Container target;
+    for (auto _ : state)
+    {
+        target = source;
+        benchmark::DoNotOptimize(target.begin());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+template <typename Container>
+void BM_PushBackCode(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const Trivial value = MakeValue<Trivial>(0);
+    InstructionCounter instructions;
+    if (instructions.IsAvailable())
+    {
+        instructions.Start();
+    }
+    for (auto _ : state)
+    {
+        Container v;
+        for (size_t i = 0; i < n; ++i)
+        {
+            PushBackCode(v, value);
+        }
+        benchmark::DoNotOptimize(v.begin());
+        benchmark::ClobberMemory();
+    }
+    const double pushes = static_cast<double>(state.iterations() * n);
+    if (instructions.IsAvailable())
+    {
+        state.counters["instructions_per_push"] = static_cast<double>(instructions.Stop()) / pushes;
+    }
+    if (const size_t code_bytes = PushBackCodeBytes<Container>(); code_bytes != 0)
+    {
+        state.counters["code_bytes"] = static_cast<double>(code_bytes);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(pushes));
+}
+
+// Поиск отсутствующего значения просматривает весь вектор
+template <typename Container>
+void BM_Find(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    Container v;
+    Reserve(v, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        PushBack(v, static_cast<float>(i % 1000));
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(FindValue(v, -1.0f));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * n * sizeof(float)));
+}
+
+template <typename Container>
+void BM_Accumulate(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    Container v;
+    Reserve(v, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        PushBack(v, static_cast<float>(i % 1000));
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Sum(v));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * n * sizeof(float)));
+}
+
+constexpr int64_t MAX_TRIVIAL_SIZE = 100'000'000;
+constexpr int64_t MAX_SIZE = 1'000'000;
+constexpr int64_t MIDDLE_SIZE = 100'000;
+
+}  // namespace
+
+#define VECTOR_BENCHMARK(Name, Type, MaxSize)                                            \
+    BENCHMARK_TEMPLATE(Name, std::vector<Type>)->RangeMultiplier(10)->Range(1, MaxSize); \
+    BENCHMARK_TEMPLATE(Name, Vector<Type>)->RangeMultiplier(10)->Range(1, MaxSize)
+
+VECTOR_BENCHMARK(BM_PushBack, Trivial, MAX_TRIVIAL_SIZE);
+VECTOR_BENCHMARK(BM_PushBack, NothrowMovable, MAX_SIZE);
+VECTOR_BENCHMARK(BM_PushBack, CopyOnly, MAX_SIZE);
+
+VECTOR_BENCHMARK(BM_EmplaceBack, Trivial, MAX_TRIVIAL_SIZE);
+VECTOR_BENCHMARK(BM_EmplaceBack, NothrowMovable, MAX_SIZE);
+VECTOR_BENCHMARK(BM_EmplaceBack, CopyOnly, MAX_SIZE);
+
+VECTOR_BENCHMARK(BM_ReserveFill, Trivial, MAX_TRIVIAL_SIZE);
+VECTOR_BENCHMARK(BM_ReserveFill, NothrowMovable, MAX_SIZE);
+VECTOR_BENCHMARK(BM_ReserveFill, CopyOnly, MAX_SIZE);
+
+VECTOR_BENCHMARK(BM_InsertEraseMiddle, Trivial, MIDDLE_SIZE);
+VECTOR_BENCHMARK(BM_InsertEraseMiddle, NothrowMovable, MIDDLE_SIZE);
+VECTOR_BENCHMARK(BM_InsertEraseMiddle, CopyOnly, MIDDLE_SIZE);
+
+VECTOR_BENCHMARK(BM_CopyAssign, Trivial, MAX_SIZE);
+VECTOR_BENCHMARK(BM_CopyAssign, NothrowMovable, MAX_SIZE);
+VECTOR_BENCHMARK(BM_CopyAssign, CopyOnly, MAX_SIZE);
+
+VECTOR_BENCHMARK(BM_PushBackCode, Trivial, MAX_SIZE);
+
+VECTOR_BENCHMARK(BM_Find, float, MAX_SIZE);
+VECTOR_BENCHMARK(BM_Accumulate, float, MAX_SIZE);
+
+BENCHMARK_MAIN();
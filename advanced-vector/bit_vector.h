@@ -0,0 +1,462 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#if defined(__cpp_lib_bitops)
+#include <bit>
+#endif
+
+/*
+BitVector — вектор флагов, хранящий по одному биту на элемент в 64-битных словах
+RawMemory<uint64_t, Alloc>. Vector<bool> не специализирован и тратит на флаг байт,
+BitVector в 8 раз компактнее.
+
+Доступ к отдельному биту идёт через прокси-объект BitVector::Reference, а групповые
+операции обрабатывают по слову за раз: Count() суммирует popcount слов, FindFirst()
+и FindNext() пропускают нулевые слова и находят бит через count trailing zeros,
+&=, |= и ^= объединяют векторы одинакового размера пословно. Циклы по словам простые,
+поэтому компилятор векторизует их, а popcount при -mpopcnt (или AVX-512 VPOPCNTDQ)
+выполняется аппаратной инструкцией.
+
+Биты последнего слова за пределами Size() всегда нулевые, на этом основаны Count()
+и сравнение векторов.
+*/
+
+// Количество единичных битов слова
+inline constexpr size_t BitVectorPopcount(uint64_t word) noexcept
+{
+#if defined(__cpp_lib_bitops)
+    return static_cast<size_t>(std::popcount(word));
+#elif defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_popcountll(word));
+#else
+    word = word - ((word >> 1) & 0x5555555555555555);
+    word = (word & 0x3333333333333333) + ((word >> 2) & 0x3333333333333333);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0F;
+    return static_cast<size_t>((word * 0x0101010101010101) >> 56);
+#endif
+}
+
+// Номер младшего единичного бита ненулевого слова
+inline constexpr size_t BitVectorCountTrailingZeros(uint64_t word) noexcept
+{
+    assert(word != 0);
+#if defined(__cpp_lib_bitops)
+    return static_cast<size_t>(std::countr_zero(word));
+#elif defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctzll(word));
+#else
+    size_t result = 0;
+    while ((word & 1) == 0)
+    {
+        word >>= 1;
+        ++result;
+    }
+    return result;
+#endif
+}
+
+template <typename Alloc = std::allocator<uint64_t>>
+class BitVector
+{
+public:
+    using allocator_type = Alloc;
+
+    static constexpr size_t WORD_BITS = std::numeric_limits<uint64_t>::digits;
+    // Результат FindFirst и FindNext, если единичных битов нет
+    static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+    // Ссылка на бит: читается как bool, присваиванием меняет бит в слове
+    class Reference
+    {
+    public:
+        Reference(uint64_t& word, uint64_t mask) noexcept
+            : word_(&word)
+            , mask_(mask)
+        {}
+
+        Reference(const Reference&) = default;
+
+        Reference& operator=(bool value) noexcept
+        {
+            if (value)
+            {
+                *word_ |= mask_;
+            }
+            else
+            {
+                *word_ &= ~mask_;
+            }
+            return *this;
+        }
+
+        Reference& operator=(const Reference& other) noexcept
+        {
+            return *this = static_cast<bool>(other);
+        }
+
+        operator bool() const noexcept
+        {
+            return (*word_ & mask_) != 0;
+        }
+
+        void Flip() noexcept
+        {
+            *word_ ^= mask_;
+        }
+
+    private:
+        uint64_t* word_;
+        uint64_t mask_;
+    };
+
+    BitVector() = default;
+
+    explicit BitVector(const Alloc& alloc) noexcept
+        : words_(alloc)
+    {}
+
+    explicit BitVector(size_t size, bool value = false, const Alloc& alloc = Alloc())
+        : words_(WordCount(size), alloc)
+        , size_(size)
+    {
+        FillWords(0, WordCount(size), value);
+        ClearTail();
+    }
+
+    BitVector(const BitVector& other)
+        : words_(WordCount(other.size_),
+                 std::allocator_traits<Alloc>::select_on_container_copy_construction(other.words_.GetAllocator()))
+        , size_(other.size_)
+    {
+        CopyWords(other.words_.GetAddress(), WordCount(size_), words_.GetAddress());
+    }
+
+    BitVector(BitVector&& other) noexcept
+        : words_(std::move(other.words_))
+        , size_(std::exchange(other.size_, 0))
+    {}
+
+    // Копия создаётся аллокатором приёмника, поэтому обмен безопасен
+    BitVector& operator=(const BitVector& rhs)
+    {
+        if (this != &rhs)
+        {
+            if (words_.Capacity() < WordCount(rhs.size_))
+            {
+                RawMemory<uint64_t, Alloc> new_words(WordCount(rhs.size_), words_.GetAllocator());
+                words_.Swap(new_words);
+            }
+            CopyWords(rhs.words_.GetAddress(), WordCount(rhs.size_), words_.GetAddress());
+            size_ = rhs.size_;
+        }
+        return *this;
+    }
+
+    BitVector& operator=(BitVector&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            words_ = std::move(rhs.words_);
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    void Swap(BitVector& other) noexcept
+    {
+        words_.Swap(other.words_);
+        std::swap(size_, other.size_);
+    }
+
+    size_t Size() const noexcept
+    {
+        return size_;
+    }
+
+    bool Empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    // Вместимость в битах
+    size_t Capacity() const noexcept
+    {
+        return words_.Capacity() * WORD_BITS;
+    }
+
+    // Количество слов, занятых битами вектора
+    size_t WordsSize() const noexcept
+    {
+        return WordCount(size_);
+    }
+
+    // Слова с битами вектора: бит i хранится в бите i % 64 слова i / 64
+    const uint64_t* Words() const noexcept
+    {
+        return words_.GetAddress();
+    }
+
+    Alloc GetAllocator() const noexcept
+    {
+        return words_.GetAllocator();
+    }
+
+    bool operator[](size_t index) const noexcept
+    {
+        assert(index < size_);
+        return (words_[index / WORD_BITS] & BitMask(index)) != 0;
+    }
+
+    Reference operator[](size_t index) noexcept
+    {
+        assert(index < size_);
+        return Reference(words_[index / WORD_BITS], BitMask(index));
+    }
+
+    void Set(size_t index, bool value = true) noexcept
+    {
+        (*this)[index] = value;
+    }
+
+    void Reset(size_t index) noexcept
+    {
+        (*this)[index] = false;
+    }
+
+    void Flip(size_t index) noexcept
+    {
+        (*this)[index].Flip();
+    }
+
+    // Обеспечивает вместимость не меньше capacity битов
+    void Reserve(size_t capacity)
+    {
+        const size_t word_capacity = WordCount(capacity);
+        if (word_capacity <= words_.Capacity())
+        {
+            return;
+        }
+        RawMemory<uint64_t, Alloc> new_words(word_capacity, words_.GetAllocator());
+        CopyWords(words_.GetAddress(), WordCount(size_), new_words.GetAddress());
+        words_.Swap(new_words);
+    }
+
+    // Добавленные биты получают значение value
+    void Resize(size_t new_size, bool value = false)
+    {
+        if (new_size > size_)
+        {
+            Reserve(new_size);
+            const size_t old_words = WordCount(size_);
+            if (value && size_ % WORD_BITS != 0)
+            {
+                words_[old_words - 1] |= ~uint64_t{ 0 } << (size_ % WORD_BITS);
+            }
+            FillWords(old_words, WordCount(new_size), value);
+        }
+        size_ = new_size;
+        ClearTail();
+    }
+
+    void PushBack(bool value)
+    {
+        if (size_ == Capacity())
+        {
+            const size_t words = words_.Capacity();
+            Reserve((words == 0 ? 1 : words * 2) * WORD_BITS);
+        }
+        if (size_ % WORD_BITS == 0)
+        {
+            words_[size_ / WORD_BITS] = 0;
+        }
+        ++size_;
+        (*this)[size_ - 1] = value;
+    }
+
+    void PopBack() noexcept
+    {
+        assert(size_ != 0);
+        --size_;
+        ClearTail();
+    }
+
+    void Clear() noexcept
+    {
+        size_ = 0;
+    }
+
+    // Количество единичных битов
+    size_t Count() const noexcept
+    {
+        const uint64_t* words = words_.GetAddress();
+        const size_t word_count = WordCount(size_);
+        // Независимые суммы не ждут друг друга и векторизуются
+        size_t sums[4] = {};
+        size_t i = 0;
+        for (; i + 4 <= word_count; i += 4)
+        {
+            sums[0] += BitVectorPopcount(words[i]);
+            sums[1] += BitVectorPopcount(words[i + 1]);
+            sums[2] += BitVectorPopcount(words[i + 2]);
+            sums[3] += BitVectorPopcount(words[i + 3]);
+        }
+        for (; i < word_count; ++i)
+        {
+            sums[0] += BitVectorPopcount(words[i]);
+        }
+        return sums[0] + sums[1] + sums[2] + sums[3];
+    }
+
+    bool Any() const noexcept
+    {
+        return FindFirst() != NPOS;
+    }
+
+    bool None() const noexcept
+    {
+        return !Any();
+    }
+
+    // Индекс первого единичного бита или NPOS
+    size_t FindFirst() const noexcept
+    {
+        return FindFromWord(0);
+    }
+
+    // Индекс первого единичного бита после from или NPOS
+    size_t FindNext(size_t from) const noexcept
+    {
+        const size_t index = from + 1;
+        if (index >= size_)
+        {
+            return NPOS;
+        }
+        const uint64_t word = words_[index / WORD_BITS] & (~uint64_t{ 0 } << (index % WORD_BITS));
+        if (word != 0)
+        {
+            return index / WORD_BITS * WORD_BITS + BitVectorCountTrailingZeros(word);
+        }
+        return FindFromWord(index / WORD_BITS + 1);
+    }
+
+    // Пословные операции над векторами одинакового размера
+    BitVector& operator&=(const BitVector& other) noexcept
+    {
+        return CombineWith(other, [](uint64_t lhs, uint64_t rhs) {
+            return lhs & rhs;
+        });
+    }
+
+    BitVector& operator|=(const BitVector& other) noexcept
+    {
+        return CombineWith(other, [](uint64_t lhs, uint64_t rhs) {
+            return lhs | rhs;
+        });
+    }
+
+    BitVector& operator^=(const BitVector& other) noexcept
+    {
+        return CombineWith(other, [](uint64_t lhs, uint64_t rhs) {
+            return lhs ^ rhs;
+        });
+    }
+
+    // Инвертирует все биты
+    void FlipAll() noexcept
+    {
+        uint64_t* words = words_.GetAddress();
+        const size_t word_count = WordCount(size_);
+        for (size_t i = 0; i < word_count; ++i)
+        {
+            words[i] = ~words[i];
+        }
+        ClearTail();
+    }
+
+    friend bool operator==(const BitVector& lhs, const BitVector& rhs) noexcept
+    {
+        return lhs.size_ == rhs.size_
+            && (lhs.size_ == 0
+                || std::memcmp(lhs.words_.GetAddress(), rhs.words_.GetAddress(),
+                               WordCount(lhs.size_) * sizeof(uint64_t)) == 0);
+    }
+
+    friend bool operator!=(const BitVector& lhs, const BitVector& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    static constexpr size_t WordCount(size_t bits) noexcept
+    {
+        return bits / WORD_BITS + (bits % WORD_BITS != 0 ? 1 : 0);
+    }
+
+    static constexpr uint64_t BitMask(size_t index) noexcept
+    {
+        return uint64_t{ 1 } << (index % WORD_BITS);
+    }
+
+    static void CopyWords(const uint64_t* from, size_t count, uint64_t* to) noexcept
+    {
+        if (count != 0)
+        {
+            std::memcpy(to, from, count * sizeof(uint64_t));
+        }
+    }
+
+    void FillWords(size_t first, size_t last, bool value) noexcept
+    {
+        std::fill(words_.GetAddress() + first, words_.GetAddress() + last, value ? ~uint64_t{ 0 } : 0);
+    }
+
+    // Обнуляет биты последнего слова за пределами size_
+    void ClearTail() noexcept
+    {
+        if (size_ % WORD_BITS != 0)
+        {
+            words_[size_ / WORD_BITS] &= ~(~uint64_t{ 0 } << (size_ % WORD_BITS));
+        }
+    }
+
+    size_t FindFromWord(size_t first_word) const noexcept
+    {
+        const uint64_t* words = words_.GetAddress();
+        const size_t word_count = WordCount(size_);
+        for (size_t i = first_word; i < word_count; ++i)
+        {
+            if (words[i] != 0)
+            {
+                return i * WORD_BITS + BitVectorCountTrailingZeros(words[i]);
+            }
+        }
+        return NPOS;
+    }
+
+    template <typename Operation>
+    BitVector& CombineWith(const BitVector& other, Operation operation) noexcept
+    {
+        assert(size_ == other.size_);
+        uint64_t* words = words_.GetAddress();
+        const uint64_t* other_words = other.words_.GetAddress();
+        const size_t word_count = WordCount(size_);
+        for (size_t i = 0; i < word_count; ++i)
+        {
+            words[i] = operation(words[i], other_words[i]);
+        }
+        return *this;
+    }
+
+    RawMemory<uint64_t, Alloc> words_;
+    size_t size_ = 0;
+};
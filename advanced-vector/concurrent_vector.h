@@ -0,0 +1,345 @@
+#pragma once
+
+#include "vector.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+/*
+ConcurrentVector<T> — вектор только для добавления, в который могут
+одновременно писать несколько потоков без блокировок.
+
+Элементы хранятся в сегментах, размер которых удваивается: сегмент k вмещает
+FIRST_SEGMENT_SIZE << k ячеек. Сегменты никогда не перевыделяются, поэтому
+созданные элементы не перемещаются, а ссылки на них остаются действительными
+всё время жизни контейнера. Рядом с каждым элементом хранится флаг готовности.
+
+EmplaceBack:
+1. если сегмент для следующей ячейки ещё не выделен, выделяет его и публикует
+   указатель через compare_exchange (проигравший поток освобождает свой сегмент);
+2. захватывает индекс этой ячейки операцией compare_exchange над счётчиком
+   захваченных ячеек (если ячейку занял другой поток, шаг 1 повторяется);
+3. создаёт элемент в ячейке и отмечает её готовой;
+4. продвигает размер через все готовые ячейки подряд, в том числе чужие.
+   Поток не ждёт других писателей: ячейку, готовую позже, опубликует тот, кто
+   её заполнил, либо любой другой писатель, завершивший запись после неё.
+
+Читатели без блокировок обходят опубликованный префикс — первые Size() элементов.
+Size() читается с memory_order_acquire, поэтому все элементы префикса видны
+полностью созданными. Пока писатель не заполнил захваченную ячейку, элементы
+после неё создаются, но читателям не видны.
+
+Конструктор элемента вызывается до захвата ячейки, если он может выбросить
+исключение: элемент создаётся во временном объекте и затем перемещается в ячейку
+noexcept-конструктором. Сегмент тоже выделяется до захвата, поэтому ни
+исключение конструктора, ни нехватка памяти не оставляют в контейнере
+захваченной, но пустой ячейки: контейнер не меняется.
+*/
+template <typename T, typename Alloc = std::allocator<T>, size_t FIRST_SEGMENT_SIZE = 64>
+class ConcurrentVector
+{
+    static_assert(FIRST_SEGMENT_SIZE != 0 && (FIRST_SEGMENT_SIZE & (FIRST_SEGMENT_SIZE - 1)) == 0,
+                  "FIRST_SEGMENT_SIZE must be a power of two");
+    static_assert(std::is_nothrow_move_constructible_v<T>,
+                  "ConcurrentVector requires a nothrow move constructor");
+
+public:
+    using allocator_type = Alloc;
+
+    class const_iterator;
+
+    ConcurrentVector() = default;
+
+    explicit ConcurrentVector(const Alloc& alloc)
+        : alloc_(alloc)
+    {}
+
+    // Контейнер разделяется потоками по ссылке, поэтому копирование и перемещение запрещены
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    // К моменту разрушения все писатели должны завершиться
+    ~ConcurrentVector()
+    {
+        const size_t size = size_.load(std::memory_order_acquire);
+        assert(size == claimed_.load(std::memory_order_relaxed));
+        for (size_t i = 0; i < size; ++i)
+        {
+            std::destroy_at(SlotAt(i)->Get());
+        }
+    }
+
+    // Добавляет элемент и возвращает ссылку на него. Можно вызывать из нескольких потоков
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args)
+    {
+        if constexpr (std::is_nothrow_constructible_v<T, Args&&...>)
+        {
+            return EmplaceAt(ClaimSlot(), std::forward<Args>(args)...);
+        }
+        else
+        {
+            T value(std::forward<Args>(args)...);
+            return EmplaceAt(ClaimSlot(), std::move(value));
+        }
+    }
+
+    T& PushBack(const T& value)
+    {
+        return EmplaceBack(value);
+    }
+
+    T& PushBack(T&& value)
+    {
+        return EmplaceBack(std::move(value));
+    }
+
+    // Выделяет сегменты для первых capacity элементов. Можно вызывать из нескольких потоков
+    void Reserve(size_t capacity)
+    {
+        if (capacity == 0)
+        {
+            return;
+        }
+        const size_t last_segment = SegmentIndex(capacity - 1);
+        for (size_t k = 0; k <= last_segment; ++k)
+        {
+            if (segments_[k].load(std::memory_order_acquire) == nullptr)
+            {
+                PublishSegment(k);
+            }
+        }
+    }
+
+    // Количество опубликованных элементов. Все они доступны для чтения без блокировок
+    size_t Size() const noexcept
+    {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    const T& operator[](size_t index) const noexcept
+    {
+        return const_cast<ConcurrentVector&>(*this)[index];
+    }
+
+    // Индекс должен быть меньше значения Size(), прочитанного этим потоком
+    T& operator[](size_t index) noexcept
+    {
+        assert(index < claimed_.load(std::memory_order_relaxed));
+        return *SlotAt(index)->Get();
+    }
+
+    // Итераторы обходят префикс, опубликованный к моменту вызова end()
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, Size());
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    Alloc GetAllocator() const noexcept
+    {
+        return alloc_;
+    }
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+
+        const_iterator(const ConcurrentVector* container, size_t index) noexcept
+            : container_(container)
+            , index_(index)
+        {}
+
+        reference operator*() const noexcept
+        {
+            return (*container_)[index_];
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &**this;
+        }
+
+        const_iterator& operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            const_iterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) noexcept
+        {
+            return lhs.container_ == rhs.container_ && lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        const ConcurrentVector* container_ = nullptr;
+        size_t index_ = 0;
+    };
+
+private:
+    // Ячейка сегмента: место под элемент и признак того, что элемент создан
+    struct Slot
+    {
+        T* Get() noexcept
+        {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+
+        alignas(T) unsigned char storage[sizeof(T)];
+        std::atomic<bool> ready{ false };
+    };
+
+    using SlotAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Slot>;
+
+    static constexpr size_t FloorLog2(size_t value) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return std::numeric_limits<unsigned long long>::digits - 1 - __builtin_clzll(value);
+#else
+        size_t result = 0;
+        while (value >>= 1)
+        {
+            ++result;
+        }
+        return result;
+#endif
+    }
+
+    static constexpr size_t FIRST_SEGMENT_SHIFT = FloorLog2(FIRST_SEGMENT_SIZE);
+    static constexpr size_t MAX_SEGMENTS = std::numeric_limits<size_t>::digits - FIRST_SEGMENT_SHIFT;
+
+    // Сегмент k хранит элементы с индексами [(2^k - 1) * F, (2^(k+1) - 1) * F)
+    static size_t SegmentIndex(size_t index) noexcept
+    {
+        return FloorLog2((index >> FIRST_SEGMENT_SHIFT) + 1);
+    }
+
+    static size_t SegmentBase(size_t segment) noexcept
+    {
+        return ((size_t{ 1 } << segment) - 1) << FIRST_SEGMENT_SHIFT;
+    }
+
+    static size_t SegmentCapacity(size_t segment) noexcept
+    {
+        return FIRST_SEGMENT_SIZE << segment;
+    }
+
+    // Захватывает ячейку, сегмент которой уже выделен. Нехватка памяти
+    // выбрасывает исключение до захвата, и контейнер не меняется
+    size_t ClaimSlot()
+    {
+        size_t index = claimed_.load(std::memory_order_acquire);
+        do
+        {
+            const size_t segment = SegmentIndex(index);
+            if (segments_[segment].load(std::memory_order_acquire) == nullptr)
+            {
+                PublishSegment(segment);
+            }
+        }
+        // release: поток, увидевший захват ячейки, видит и адрес её сегмента
+        while (!claimed_.compare_exchange_weak(index, index + 1, std::memory_order_acq_rel,
+                                               std::memory_order_acquire));
+        return index;
+    }
+
+    // Вызывается после захвата ячейки, поэтому не должна выбрасывать исключений
+    template <typename... Args>
+    T& EmplaceAt(size_t index, Args&&... args) noexcept
+    {
+        Slot* slot = SlotAt(index);
+        T* value = new(slot->storage) T(std::forward<Args>(args)...);
+        slot->ready.store(true, std::memory_order_seq_cst);
+        AdvanceSize();
+        return *value;
+    }
+
+    /*
+    Продвигает размер через готовые ячейки. Флаги готовности и размер читаются
+    и пишутся с memory_order_seq_cst: если писатель ячейки i увидел размер
+    меньше i, значит, поток, который позже продвинет размер до i, увидит её
+    флаг, и ячейка не останется неопубликованной.
+    */
+    void AdvanceSize() noexcept
+    {
+        size_t size = size_.load(std::memory_order_seq_cst);
+        while (size < claimed_.load(std::memory_order_acquire)
+               && SlotAt(size)->ready.load(std::memory_order_seq_cst))
+        {
+            if (size_.compare_exchange_weak(size, size + 1, std::memory_order_seq_cst))
+            {
+                ++size;
+            }
+        }
+    }
+
+    // Выделяет сегмент и публикует его, если другой поток не сделал этого раньше
+    Slot* PublishSegment(size_t segment)
+    {
+        RawMemory<Slot, SlotAlloc> memory(SegmentCapacity(segment), SlotAlloc(alloc_));
+        std::uninitialized_default_construct_n(memory.GetAddress(), SegmentCapacity(segment));
+        Slot* expected = nullptr;
+        if (segments_[segment].compare_exchange_strong(expected, memory.GetAddress(), std::memory_order_acq_rel))
+        {
+            // Ячейку владельца записывает только поток, опубликовавший сегмент
+            owners_[segment] = std::move(memory);
+            return owners_[segment].GetAddress();
+        }
+        return expected;
+    }
+
+    Slot* SlotAt(size_t index) noexcept
+    {
+        const size_t segment = SegmentIndex(index);
+        return segments_[segment].load(std::memory_order_acquire) + (index - SegmentBase(segment));
+    }
+
+    Alloc alloc_;
+    std::atomic<size_t> claimed_{ 0 };
+    std::atomic<size_t> size_{ 0 };
+    // Опубликованные адреса сегментов, доступные читателям без блокировок
+    std::atomic<Slot*> segments_[MAX_SEGMENTS] = {};
+    // Владельцы памяти сегментов, освобождают её при разрушении контейнера.
+    // Ячейки тривиально разрушаемы, а элементы разрушает деструктор контейнера
+    RawMemory<Slot, SlotAlloc> owners_[MAX_SEGMENTS];
+};
@@ -0,0 +1,287 @@
+#pragma once
+
+#include "vector.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/*
+CowVector<T> — вектор с копированием при записи для данных, которые часто
+читаются и редко меняются (таблицы конфигурации, справочники).
+
+Копии CowVector разделяют один буфер: копирование лишь увеличивает счётчик
+ссылок и не копирует элементы. Перед первым изменением Mutable() создаёт
+собственную копию элементов, если буфер разделяется с другими CowVector,
+поэтому изменения никогда не видны через другие копии.
+
+Буфер хранится в блоке вместе с атомарным счётчиком ссылок, поэтому копии
+одного CowVector можно одновременно читать, копировать и разрушать из разных
+потоков. Один и тот же объект CowVector, как и Vector, нельзя менять
+одновременно с другими операциями над ним.
+
+Ссылка, которую вернул Mutable(), действительна, пока CowVector не скопирован:
+после копирования буфер снова разделяется, и изменения через старую ссылку
+стали бы видны в копии. Для нового изменения снова вызовите Mutable().
+
+CowVectorPublisher<T> хранит текущий снимок для множества читателей: Load()
+возвращает копию снимка (без копирования элементов), Publish() атомарно
+заменяет его. Снимок хранится в std::shared_ptr, который читается и заменяется
+атомарными операциями (std::atomic<std::shared_ptr> в C++20); Publish
+выделяет для него блок управления. Читатель, получивший снимок, работает с ним без синхронизации,
+даже если писатель уже опубликовал новый.
+*/
+template <typename T, typename Alloc = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class CowVector
+{
+public:
+    using VectorType = Vector<T, Alloc, GrowthPolicy>;
+    using value_type = T;
+    using allocator_type = Alloc;
+    using const_iterator = const T*;
+
+    CowVector() = default;
+
+    explicit CowVector(const Alloc& alloc) noexcept
+        : alloc_(alloc)
+    {}
+
+    // Забирает элементы вектора без копирования
+    explicit CowVector(VectorType&& data)
+        : alloc_(data.GetAllocator())
+        , block_(NewBlock(alloc_, std::move(data)))
+    {}
+
+    CowVector(const CowVector& other) noexcept
+        : alloc_(other.alloc_)
+        , block_(other.block_)
+    {
+        if (block_ != nullptr)
+        {
+            block_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CowVector(CowVector&& other) noexcept
+        : alloc_(other.alloc_)
+        , block_(std::exchange(other.block_, nullptr))
+    {}
+
+    CowVector& operator=(const CowVector& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            CowVector copy(rhs);
+            Swap(copy);
+        }
+        return *this;
+    }
+
+    CowVector& operator=(CowVector&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            CowVector moved(std::move(rhs));
+            Swap(moved);
+        }
+        return *this;
+    }
+
+    ~CowVector()
+    {
+        Release(block_, alloc_);
+    }
+
+    void Swap(CowVector& other) noexcept
+    {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        swap(block_, other.block_);
+    }
+
+    size_t Size() const noexcept
+    {
+        return block_ != nullptr ? block_->data.Size() : 0;
+    }
+
+    bool Empty() const noexcept
+    {
+        return Size() == 0;
+    }
+
+    size_t Capacity() const noexcept
+    {
+        return block_ != nullptr ? block_->data.Capacity() : 0;
+    }
+
+    const T* Data() const noexcept
+    {
+        return block_ != nullptr ? block_->data.Data() : nullptr;
+    }
+
+    const T& operator[](size_t index) const noexcept
+    {
+        assert(index < Size());
+        return Data()[index];
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return Data();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return Data() + Size();
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    allocator_type GetAllocator() const noexcept
+    {
+        return alloc_;
+    }
+
+    // Количество CowVector, разделяющих буфер (0 у пустого CowVector без буфера)
+    size_t UseCount() const noexcept
+    {
+        return block_ != nullptr ? block_->refs.load(std::memory_order_acquire) : 0;
+    }
+
+    bool IsShared() const noexcept
+    {
+        return UseCount() > 1;
+    }
+
+    // Вектор для изменения. Если буфер разделяется, сначала копирует элементы.
+    // Строгая гарантия: при исключении CowVector не меняется
+    VectorType& Mutable()
+    {
+        if (block_ == nullptr)
+        {
+            block_ = NewBlock(alloc_, VectorType(alloc_));
+        }
+        // acquire связывает чтения буфера другими владельцами, отпустившими его, с последующими записями
+        else if (block_->refs.load(std::memory_order_acquire) != 1)
+        {
+            Block* copy = NewBlock(alloc_, block_->data);
+            Release(block_, alloc_);
+            block_ = copy;
+        }
+        return block_->data;
+    }
+
+private:
+    struct Block
+    {
+        template <typename Data>
+        explicit Block(Data&& from)
+            : data(std::forward<Data>(from))
+        {}
+
+        std::atomic<size_t> refs{ 1 };
+        VectorType data;
+    };
+
+    using BlockAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Block>;
+    using BlockTraits = std::allocator_traits<BlockAlloc>;
+
+    template <typename Data>
+    static Block* NewBlock(const Alloc& alloc, Data&& data)
+    {
+        BlockAlloc block_alloc(alloc);
+        Block* block = BlockTraits::allocate(block_alloc, 1);
+        try
+        {
+            BlockTraits::construct(block_alloc, block, std::forward<Data>(data));
+        }
+        catch (...)
+        {
+            BlockTraits::deallocate(block_alloc, block, 1);
+            throw;
+        }
+        return block;
+    }
+
+    static void Release(Block* block, const Alloc& alloc) noexcept
+    {
+        // Последний владелец должен видеть все чтения остальных: acq_rel
+        if (block != nullptr && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            BlockAlloc block_alloc(alloc);
+            BlockTraits::destroy(block_alloc, block);
+            BlockTraits::deallocate(block_alloc, block, 1);
+        }
+    }
+
+    Alloc alloc_;
+    Block* block_ = nullptr;
+};
+
+// В libstdc++ до GCC 13 std::atomic<std::shared_ptr>::load снимает блокировку с memory_order_relaxed,
+// и её чтение указателя гонится с Publish. Там используются атомарные функции для shared_ptr
+#if defined(__cpp_lib_atomic_shared_ptr) && !(defined(_GLIBCXX_RELEASE) && _GLIBCXX_RELEASE < 13)
+#define VECTOR_ATOMIC_SHARED_PTR 1
+#else
+#define VECTOR_ATOMIC_SHARED_PTR 0
+#endif
+
+template <typename T, typename Alloc = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class CowVectorPublisher
+{
+public:
+    using Snapshot = CowVector<T, Alloc, GrowthPolicy>;
+
+    CowVectorPublisher()
+        : CowVectorPublisher(Snapshot())
+    {}
+
+    explicit CowVectorPublisher(Snapshot snapshot)
+        : current_(std::make_shared<const Snapshot>(std::move(snapshot)))
+    {}
+
+    // Публикатор разделяется потоками по ссылке
+    CowVectorPublisher(const CowVectorPublisher&) = delete;
+    CowVectorPublisher& operator=(const CowVectorPublisher&) = delete;
+
+    // Текущий снимок. Читатель атомарно берёт указатель и лишь увеличивает счётчик ссылок буфера
+    Snapshot Load() const
+    {
+#if VECTOR_ATOMIC_SHARED_PTR
+        const std::shared_ptr<const Snapshot> current = current_.load(std::memory_order_acquire);
+#else
+        const std::shared_ptr<const Snapshot> current = std::atomic_load_explicit(&current_, std::memory_order_acquire);
+#endif
+        return *current;
+    }
+
+    // Атомарно заменяет снимок. Старый буфер освобождается, когда его отпустит последний читатель
+    void Publish(Snapshot snapshot)
+    {
+        std::shared_ptr<const Snapshot> next = std::make_shared<const Snapshot>(std::move(snapshot));
+#if VECTOR_ATOMIC_SHARED_PTR
+        current_.store(std::move(next), std::memory_order_release);
+#else
+        std::atomic_store_explicit(&current_, std::move(next), std::memory_order_release);
+#endif
+    }
+
+private:
+    // Снимок публикуется через shared_ptr: CowVector нельзя атомарно скопировать,
+    // а атомарные операции над shared_ptr дают читателям копию без блокировки публикатора
+#if VECTOR_ATOMIC_SHARED_PTR
+    std::atomic<std::shared_ptr<const Snapshot>> current_;
+#else
+    std::shared_ptr<const Snapshot> current_;
+#endif
+};
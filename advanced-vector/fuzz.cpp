@@ -0,0 +1,575 @@
+#include "allocators.h"
+#include "small_vector.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+Дифференциальный фаззинг Vector: входные байты превращаются в последовательность
+операций, которая выполняется над проверяемым контейнером и над std::vector.
+После каждой операции содержимое контейнеров сравнивается.
+
+Элементы FuzzValue владеют памятью в куче и выбрасывают исключение при заданном
+по счёту копировании или создании, поэтому проверяются и пути отката. После
+исключения операции со строгой гарантией не должны менять контейнер, остальные
+должны оставить его согласованным (все элементы живы). Каждый вход прогоняется
+через несколько контейнеров, чтобы задеть быстрые пути: побайтовый перенос
+(is_trivially_relocatable), копирование вместо перемещения для элементов без
+noexcept-перемещения, reallocate (MallocAllocator) и встроенный буфер SmallVector.
+
+Сборка с libFuzzer (clang):
+    clang++ -std=c++17 -g -O1 -fsanitize=fuzzer,address,undefined -DVECTOR_FUZZ_LIBFUZZER fuzz.cpp -o vector_fuzz
+Без libFuzzer fuzz.cpp собирается любым компилятором и прогоняет случайные входы:
+    ./vector_fuzz [количество входов [seed]]
+*/
+
+namespace
+{
+
+// Проверка, которая работает и в сборке с NDEBUG
+#define FUZZ_CHECK(condition)                                                              \
+    do                                                                                     \
+    {                                                                                      \
+        if (!(condition))                                                                  \
+        {                                                                                  \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            std::abort();                                                                  \
+        }                                                                                  \
+    } while (false)
+
+constexpr size_t MAX_SIZE = 256;
+
+struct FuzzException
+{};
+
+// Через сколько копирований и созданий FuzzValue выбросить исключение; 0 — никогда
+int throw_countdown = 0;
+
+void MaybeThrow()
+{
+    if (throw_countdown > 0 && --throw_countdown == 0)
+    {
+        throw FuzzException();
+    }
+}
+
+template <bool RELOCATABLE, bool NOTHROW_MOVE>
+class FuzzValue
+{
+public:
+    static constexpr int MOVED_FROM = -1;
+
+    FuzzValue()
+        : FuzzValue(0)
+    {}
+
+    explicit FuzzValue(int value)
+    {
+        MaybeThrow();
+        payload_ = new int(value);
+        ++live;
+    }
+
+    FuzzValue(const FuzzValue& other)
+    {
+        other.Check();
+        MaybeThrow();
+        payload_ = other.payload_ != nullptr ? new int(*other.payload_) : nullptr;
+        ++live;
+    }
+
+    // Перемещение никогда не выбрасывает, но при NOTHROW_MOVE == false не объявлено noexcept
+    FuzzValue(FuzzValue&& other) noexcept(NOTHROW_MOVE)
+        : payload_(std::exchange(other.payload_, nullptr))
+    {
+        other.Check();
+        ++live;
+    }
+
+    FuzzValue& operator=(const FuzzValue& other)
+    {
+        Check();
+        other.Check();
+        MaybeThrow();
+        if (this != &other)
+        {
+            int* payload = other.payload_ != nullptr ? new int(*other.payload_) : nullptr;
+            delete payload_;
+            payload_ = payload;
+        }
+        return *this;
+    }
+
+    FuzzValue& operator=(FuzzValue&& other) noexcept(NOTHROW_MOVE)
+    {
+        Check();
+        other.Check();
+        if (this != &other)
+        {
+            delete payload_;
+            payload_ = std::exchange(other.payload_, nullptr);
+        }
+        return *this;
+    }
+
+    ~FuzzValue()
+    {
+        Check();
+        cookie_ = 0;
+        delete payload_;
+        --live;
+    }
+
+    int Value() const
+    {
+        Check();
+        return payload_ != nullptr ? *payload_ : MOVED_FROM;
+    }
+
+    static inline int live = 0;
+
+private:
+    static constexpr uint32_t COOKIE = 0xfeedc0de;
+
+    void Check() const
+    {
+        FUZZ_CHECK(cookie_ == COOKIE);
+    }
+
+    uint32_t cookie_ = COOKIE;
+    int* payload_ = nullptr;
+};
+
+int ValueOf(int value)
+{
+    return value;
+}
+
+template <bool RELOCATABLE, bool NOTHROW_MOVE>
+int ValueOf(const FuzzValue<RELOCATABLE, NOTHROW_MOVE>& value)
+{
+    return value.Value();
+}
+
+template <typename T>
+T Make(int value)
+{
+    return T(value);
+}
+
+template <typename T>
+struct LiveCount
+{
+    static int Get()
+    {
+        return 0;
+    }
+};
+
+template <bool RELOCATABLE, bool NOTHROW_MOVE>
+struct LiveCount<FuzzValue<RELOCATABLE, NOTHROW_MOVE>>
+{
+    static int Get()
+    {
+        return FuzzValue<RELOCATABLE, NOTHROW_MOVE>::live;
+    }
+};
+
+class FuzzInput
+{
+public:
+    FuzzInput(const uint8_t* data, size_t size) noexcept
+        : data_(data)
+        , size_(size)
+    {}
+
+    bool Empty() const noexcept
+    {
+        return position_ == size_;
+    }
+
+    uint8_t TakeByte() noexcept
+    {
+        return position_ < size_ ? data_[position_++] : 0;
+    }
+
+    // Число от 0 до bound включительно
+    size_t TakeUpTo(size_t bound) noexcept
+    {
+        return TakeByte() % (bound + 1);
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t position_ = 0;
+};
+
+// Выполняет последовательность операций над Container и std::vector<T>
+template <typename Container>
+class DifferentialRun
+{
+    using T = std::decay_t<decltype(*std::declval<Container&>().begin())>;
+
+public:
+    explicit DifferentialRun(FuzzInput input)
+        : input_(input)
+    {}
+
+    void Run()
+    {
+        const int live_before = LiveCount<T>::Get();
+        {
+            Container v;
+            std::vector<T> model;
+            while (!input_.Empty())
+            {
+                Step(v, model);
+                CheckEqual(v, model);
+            }
+        }
+        // Все созданные элементы разрушены
+        FUZZ_CHECK(LiveCount<T>::Get() == live_before);
+    }
+
+private:
+    enum Op
+    {
+        PUSH_BACK_COPY,
+        PUSH_BACK_MOVE,
+        EMPLACE_BACK,
+        POP_BACK,
+        INSERT,
+        INSERT_ALIASED,
+        INSERT_COUNT,
+        INSERT_RANGE,
+        EMPLACE_ALIASED,
+        ERASE,
+        ERASE_RANGE,
+        RESIZE,
+        RESERVE,
+        SHRINK_TO_FIT,
+        COPY_ASSIGN,
+        MOVE_ASSIGN,
+        COPY_CONSTRUCT,
+        ASSIGN_COUNT_ALIASED,
+        ASSIGN_RANGE,
+        APPEND,
+        BACK_INSERTER,
+        EMPLACE_BACK_UNCHECKED,
+        OP_COUNT
+    };
+
+    void Step(Container& v, std::vector<T>& model)
+    {
+        const Op op = static_cast<Op>(input_.TakeByte() % OP_COUNT);
+        const int throw_at = static_cast<int>(input_.TakeUpTo(7));
+        const int value = input_.TakeByte();
+        const size_t size = model.size();
+        // Позиция вставки и индекс существующего элемента
+        const size_t pos = input_.TakeUpTo(size);
+        const size_t index = size != 0 ? pos % size : 0;
+        const size_t count = input_.TakeUpTo(16);
+
+        const bool grows = op != POP_BACK && op != ERASE && op != ERASE_RANGE && op != SHRINK_TO_FIT;
+        if (grows && size + count + 1 > MAX_SIZE)
+        {
+            v.Resize(0);
+            model.clear();
+            return;
+        }
+
+        // Операции со строгой гарантией; остальные дают базовую
+        bool strong = true;
+        const Container before = v;
+        try
+        {
+            switch (op)
+            {
+            case PUSH_BACK_COPY:
+            {
+                const T element = Make<T>(value);
+                model.push_back(element);
+                Armed(throw_at, [&] { v.PushBack(element); });
+                break;
+            }
+            case PUSH_BACK_MOVE:
+            {
+                model.push_back(Make<T>(value));
+                T element = Make<T>(value);
+                Armed(throw_at, [&] { v.PushBack(std::move(element)); });
+                break;
+            }
+            case EMPLACE_BACK:
+                model.emplace_back(value);
+                Armed(throw_at, [&] { v.EmplaceBack(value); });
+                break;
+            case POP_BACK:
+                if (size != 0)
+                {
+                    model.pop_back();
+                    v.PopBack();
+                }
+                break;
+            case INSERT:
+            {
+                const T element = Make<T>(value);
+                model.insert(model.begin() + pos, element);
+                Armed(throw_at, [&] { v.Insert(v.cbegin() + pos, element); });
+                break;
+            }
+            case INSERT_ALIASED:
+                if (size != 0)
+                {
+                    model.insert(model.begin() + pos, model[index]);
+                    Armed(throw_at, [&] { v.Insert(v.cbegin() + pos, v[index]); });
+                }
+                break;
+            case INSERT_COUNT:
+            {
+                const T element = Make<T>(value);
+                model.insert(model.begin() + pos, count, element);
+                Armed(throw_at, [&] { v.Insert(v.cbegin() + pos, count, element); });
+                break;
+            }
+            case INSERT_RANGE:
+            {
+                const std::vector<T> source = MakeRange(count, value);
+                model.insert(model.begin() + pos, source.begin(), source.end());
+                Armed(throw_at, [&] { v.Insert(v.cbegin() + pos, source.begin(), source.end()); });
+                break;
+            }
+            case EMPLACE_ALIASED:
+                if (size != 0)
+                {
+                    model.emplace(model.begin() + pos, model[index]);
+                    Armed(throw_at, [&] { v.Emplace(v.cbegin() + pos, v[index]); });
+                }
+                break;
+            case ERASE:
+                if (size != 0)
+                {
+                    model.erase(model.begin() + index);
+                    v.Erase(v.cbegin() + index);
+                }
+                break;
+            case ERASE_RANGE:
+            {
+                const size_t last = std::min(size, pos + count);
+                model.erase(model.begin() + pos, model.begin() + last);
+                v.Erase(v.cbegin() + pos, v.cbegin() + last);
+                break;
+            }
+            case RESIZE:
+            {
+                const size_t new_size = input_.TakeUpTo(MAX_SIZE / 4);
+                model.resize(new_size);
+                Armed(throw_at, [&] { v.Resize(new_size); });
+                break;
+            }
+            case RESERVE:
+                Armed(throw_at, [&] { v.Reserve(size + count * 4); });
+                FUZZ_CHECK(v.Capacity() >= size + count * 4);
+                break;
+            case SHRINK_TO_FIT:
+                Armed(throw_at, [&] { v.ShrinkToFit(); });
+                break;
+            case COPY_ASSIGN:
+            {
+                strong = false;
+                const std::vector<T> source = MakeRange(count, value);
+                Container other;
+                for (const T& element : source)
+                {
+                    other.PushBack(element);
+                }
+                model = source;
+                Armed(throw_at, [&] { v = other; });
+                break;
+            }
+            case MOVE_ASSIGN:
+            {
+                const std::vector<T> source = MakeRange(count, value);
+                Container other;
+                for (const T& element : source)
+                {
+                    other.PushBack(element);
+                }
+                model = source;
+                v = std::move(other);
+                break;
+            }
+            case COPY_CONSTRUCT:
+            {
+                Armed(throw_at, [&] {
+                    const Container copy(v);
+                    CheckEqual(copy, model);
+                });
+                break;
+            }
+            case ASSIGN_COUNT_ALIASED:
+                if (size != 0)
+                {
+                    strong = false;
+                    const T element = model[index];
+                    model.assign(count, element);
+                    Armed(throw_at, [&] { v.Assign(count, v[index]); });
+                }
+                break;
+            case ASSIGN_RANGE:
+            {
+                strong = false;
+                const std::vector<T> source = MakeRange(count, value);
+                model.assign(source.begin(), source.end());
+                Armed(throw_at, [&] { v.Assign(source.begin(), source.end()); });
+                break;
+            }
+            case APPEND:
+            {
+                const std::vector<T> source = MakeRange(count, value);
+                model.insert(model.end(), source.begin(), source.end());
+                Armed(throw_at, [&] { v.Append(source.begin(), source.end()); });
+                break;
+            }
+            case BACK_INSERTER:
+            {
+                // Элементы, созданные до исключения, остаются в векторе
+                strong = false;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    model.emplace_back(value + static_cast<int>(i));
+                }
+                Armed(throw_at, [&] {
+                    auto inserter = v.ReserveBack(count);
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        inserter.EmplaceBack(value + static_cast<int>(i));
+                    }
+                });
+                break;
+            }
+            case EMPLACE_BACK_UNCHECKED:
+                if (v.Size() < v.Capacity())
+                {
+                    model.emplace_back(value);
+                    Armed(throw_at, [&] { v.EmplaceBackUnchecked(value); });
+                }
+                break;
+            case OP_COUNT:
+                break;
+            }
+        }
+        catch (const FuzzException&)
+        {
+            throw_countdown = 0;
+            CheckConsistent(v);
+            if (strong)
+            {
+                CheckEqual(v, before);
+            }
+            model.clear();
+            for (const T& element : v)
+            {
+                model.push_back(element);
+            }
+        }
+    }
+
+    // Выполняет action, выбросив исключение на throw_at-м копировании или создании элемента
+    template <typename Action>
+    static void Armed(int throw_at, Action action)
+    {
+        throw_countdown = throw_at;
+        action();
+        throw_countdown = 0;
+    }
+
+    static std::vector<T> MakeRange(size_t count, int value)
+    {
+        std::vector<T> result;
+        for (size_t i = 0; i < count; ++i)
+        {
+            result.push_back(Make<T>(value + static_cast<int>(i)));
+        }
+        return result;
+    }
+
+    static void CheckConsistent(const Container& v)
+    {
+        FUZZ_CHECK(v.Size() <= v.Capacity());
+        for (const T& element : v)
+        {
+            static_cast<void>(ValueOf(element));
+        }
+    }
+
+    template <typename Expected>
+    static void CheckEqual(const Container& v, const Expected& expected)
+    {
+        CheckConsistent(v);
+        FUZZ_CHECK(v.Size() == static_cast<size_t>(std::distance(expected.begin(), expected.end())));
+        auto it = expected.begin();
+        for (const T& element : v)
+        {
+            FUZZ_CHECK(ValueOf(element) == ValueOf(*it));
+            ++it;
+        }
+    }
+
+    FuzzInput input_;
+};
+
+using PlainValue = FuzzValue<false, true>;
+using RelocatableValue = FuzzValue<true, true>;
+using CopyOnRelocateValue = FuzzValue<false, false>;
+
+}  // namespace
+
+template <bool NOTHROW_MOVE>
+struct is_trivially_relocatable<FuzzValue<true, NOTHROW_MOVE>> : std::true_type
+{};
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    const FuzzInput input(data, size);
+    DifferentialRun<Vector<PlainValue>>(input).Run();
+    DifferentialRun<Vector<RelocatableValue>>(input).Run();
+    DifferentialRun<Vector<CopyOnRelocateValue>>(input).Run();
+    DifferentialRun<Vector<PlainValue, std::allocator<PlainValue>, ShrinkingGrowth<>>>(input).Run();
+    DifferentialRun<Vector<int, MallocAllocator<int>>>(input).Run();
+    DifferentialRun<SmallVector<PlainValue, 4>>(input).Run();
+    DifferentialRun<SmallVector<RelocatableValue, 8>>(input).Run();
+    return 0;
+}
+
+#if !defined(VECTOR_FUZZ_LIBFUZZER)
+// Запуск без libFuzzer: случайные входы, воспроизводимые по seed
+int main(int argc, char** argv)
+{
+    const unsigned long iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    const unsigned long seed = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1;
+    std::mt19937 random(static_cast<std::mt19937::result_type>(seed));
+    std::vector<uint8_t> data;
+    for (unsigned long i = 0; i < iterations; ++i)
+    {
+        data.resize(random() % 1024);
+        for (uint8_t& byte : data)
+        {
+            byte = static_cast<uint8_t>(random());
+        }
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+    }
+    std::printf("%lu inputs passed (seed %lu)\n", iterations, seed);
+    return 0;
+}
+#endif
@@ -1,10 +1,44 @@
+#include "allocators.h"
+#include "bit_vector.h"
+#include "concurrent_vector.h"
+#include "cow_vector.h"
+#include "segmented_vector.h"
+#include "small_vector.h"
+#include "soa_vector.h"
 #include "vector.h"
+#include "vector_io.h"
+#include "vector_simd.h"
 
+// Тесты считают копии в неатомарных счётчиках, а параллельный путь создаёт элементы
+// в нескольких потоках. Он проверяется отдельным файлом parallel_test.cpp
+#if defined(VECTOR_ENABLE_PARALLEL)
+#error "main.cpp must be built without VECTOR_ENABLE_PARALLEL; build parallel_test.cpp instead"
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include "persistent_vector.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <iostream>
+#include <iterator>
+#include <numeric>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
+#if defined(__cpp_lib_ranges)
+#include <ranges>
+#endif
+
 namespace
 {
 
@@ -131,8 +165,120 @@ struct Obj
     static inline int num_move_assigned = 0;
 };
 
+// Владеющий дескриптор, который безопасно переносить побайтово
+struct RelocatableHandle
+{
+    explicit RelocatableHandle(int value)
+        : ptr(std::make_unique<int>(value))
+    {}
+    RelocatableHandle(RelocatableHandle&& other) noexcept
+        : ptr(std::move(other.ptr))
+    {
+        ++num_moved;
+    }
+    RelocatableHandle& operator=(RelocatableHandle&& other) noexcept
+    {
+        ptr = std::move(other.ptr);
+        ++num_move_assigned;
+        return *this;
+    }
+
+    std::unique_ptr<int> ptr;
+
+    static inline int num_moved = 0;
+    static inline int num_move_assigned = 0;
+};
+
+// Аллокатор, который отказывает в памяти, пока тест не снимет флаг fail_allocations
+bool fail_allocations = false;
+
+template <typename T>
+struct FailingAllocator
+{
+    using value_type = T;
+
+    FailingAllocator() = default;
+
+    template <typename U>
+    FailingAllocator(const FailingAllocator<U>&) noexcept
+    {}
+
+    T* allocate(size_t n)
+    {
+        if (fail_allocations)
+        {
+            throw std::bad_alloc();
+        }
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept
+    {
+        std::allocator<T>().deallocate(ptr, n);
+    }
+
+    bool operator==(const FailingAllocator&) const noexcept
+    {
+        return true;
+    }
+
+    bool operator!=(const FailingAllocator&) const noexcept
+    {
+        return false;
+    }
+};
+
+// Перемещение не помечено noexcept, поэтому контейнеры переносят его копированием
+struct ThrowingCopy
+{
+    ThrowingCopy(int value)
+        : value(value)
+    {}
+    ThrowingCopy(const ThrowingCopy& other)
+        : value(other.value)
+    {
+        if (other.throw_on_copy)
+        {
+            throw std::runtime_error("Oops");
+        }
+    }
+    ThrowingCopy(ThrowingCopy&& other)
+        : value(other.value)
+    {}
+
+    int value = 0;
+    bool throw_on_copy = false;
+};
+
+// Переносится побитово, но перемещение может бросить исключение
+struct ThrowingMoveRelocatable
+{
+    explicit ThrowingMoveRelocatable(const std::string& name)
+        : name(name)
+    {}
+    ThrowingMoveRelocatable(ThrowingMoveRelocatable&& other) noexcept(false)
+        : name(other.name)
+    {
+        if (throw_on_move)
+        {
+            throw std::runtime_error("Oops");
+        }
+    }
+
+    std::string name;
+    static inline bool throw_on_move = false;
+};
+
 }  // namespace
 
+template <>
+struct is_trivially_relocatable<RelocatableHandle> : std::true_type
+{};
+
+template <>
+struct is_trivially_relocatable<ThrowingMoveRelocatable> : std::true_type
+{};
+
 void Test1()
 {
     Obj::ResetCounters();
@@ -595,101 +741,1936 @@ void Test6()
     }
 }
 
-struct C
+void Test7()
 {
-    C() noexcept
+    const size_t SIZE = 1000;
+    const int ID = 42;
     {
-        ++def_ctor;
+        Obj::ResetCounters();
+        MonotonicArena arena;
+        {
+            Vector<Obj, ArenaAllocator<Obj>> v{ ArenaAllocator<Obj>(arena) };
+            for (size_t i = 0; i < SIZE; ++i)
+            {
+                v.EmplaceBack(ID);
+            }
+            assert(v.Size() == SIZE);
+            assert(v[SIZE - 1].id == ID);
+            assert(arena.BytesReserved() >= SIZE * sizeof(Obj));
+
+            // Копия получает тот же ресурс
+            Vector<Obj, ArenaAllocator<Obj>> v_copy(v);
+            assert(v_copy.GetAllocator() == v.GetAllocator());
+            Vector<Obj, ArenaAllocator<Obj>> v_moved(std::move(v_copy));
+            assert(v_moved.Size() == SIZE);
+            assert(v_copy.Size() == 0);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+        arena.Release();
     }
-    C(const C& /*other*/) noexcept
     {
-        ++copy_ctor;
+        // Аллокаторы разных арен не равны и не передаются: перемещение поэлементное
+        Obj::ResetCounters();
+        MonotonicArena arena1;
+        MonotonicArena arena2;
+        Vector<Obj, ArenaAllocator<Obj>> v1(SIZE, ArenaAllocator<Obj>(arena1));
+        Vector<Obj, ArenaAllocator<Obj>> v2{ ArenaAllocator<Obj>(arena2) };
+        v1[0].id = ID;
+        v2 = std::move(v1);
+        assert(v2.GetAllocator().GetResource() == &arena2);
+        assert(v2.Size() == SIZE);
+        assert(v2[0].id == ID);
+        assert(Obj::num_moved == SIZE);
+        v2 = v1;
+        assert(v2.GetAllocator().GetResource() == &arena2);
+        assert(v2.Size() == v1.Size());
     }
-    C(C&& /*other*/) noexcept
+    assert(Obj::GetAliveObjectCount() == 0);
     {
-        ++move_ctor;
+        Obj::ResetCounters();
+        PoolResource pool;
+        Vector<Obj, PoolAllocator<Obj>> v{ PoolAllocator<Obj>(pool) };
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            v.PushBack(Obj{ static_cast<int>(i) });
+        }
+        v.Erase(v.begin());
+        assert(v.Size() == SIZE - 1);
+        assert(v[0].id == 1);
+        Vector<Obj, PoolAllocator<Obj>> other{ PoolAllocator<Obj>(pool) };
+        other.Swap(v);
+        assert(other.Size() == SIZE - 1);
+        assert(v.Size() == 0);
+        assert(PoolResource::RoundUpToClass(17) == 32);
     }
-    C& operator=(const C& other) noexcept
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test8()
+{
+    const size_t SIZE = 100;
     {
-        if (this != &other)
+        RelocatableHandle::num_moved = 0;
+        RelocatableHandle::num_move_assigned = 0;
+        Vector<RelocatableHandle> v;
+        for (size_t i = 0; i < SIZE; ++i)
         {
-            ++copy_assign;
+            v.EmplaceBack(static_cast<int>(i));
         }
-        return *this;
+        v.Reserve(SIZE * 4);
+        v.Emplace(v.cbegin() + 1, -1);
+        v.Erase(v.cbegin() + 2);
+        v.Insert(v.cbegin() + 3, RelocatableHandle{ -2 });
+        // Реаллокации и сдвиги не вызывают конструкторов перемещения и присваиваний элементов.
+        // Emplace создаёт элемент на месте, единственное перемещение — из аргумента Insert
+        assert(RelocatableHandle::num_moved == 1);
+        assert(RelocatableHandle::num_move_assigned == 0);
+        assert(v.Size() == SIZE + 1);
+        assert(*v[0].ptr == 0);
+        assert(*v[1].ptr == -1);
+        assert(*v[2].ptr == 2);
+        assert(*v[3].ptr == -2);
+        assert(*v[SIZE].ptr == static_cast<int>(SIZE - 1));
     }
-    C& operator=(C&& /*other*/) noexcept
     {
-        ++move_assign;
-        return *this;
+        Vector<int> v;
+        for (int i = 0; i < static_cast<int>(SIZE); ++i)
+        {
+            v.PushBack(i);
+        }
+        v.Insert(v.cbegin(), v[SIZE - 1]);
+        v.Erase(v.cbegin() + 1);
+        assert(v.Size() == SIZE);
+        assert(v[0] == static_cast<int>(SIZE - 1));
+        assert(v[1] == 1);
     }
-    ~C()
+}
+
+void Test9()
+{
+    const size_t SIZE = 100'000;
     {
-        ++dtor;
+        // Единственный вектор арены растёт на месте, пока хватает текущего блока
+        MonotonicArena arena(1024 * sizeof(int));
+        Vector<int, ArenaAllocator<int>> v{ ArenaAllocator<int>(arena) };
+        v.PushBack(0);
+        const int* data = &v[0];
+        for (int i = 1; i < 512; ++i)
+        {
+            v.PushBack(i);
+        }
+        assert(&v[0] == data);
+        v.Reserve(1000);
+        assert(&v[0] == data);
+        assert(v.Capacity() == 1000);
+        assert(v[511] == 511);
+    }
+    {
+        // Запрос, размер которого с выравниванием не помещается в size_t, бросает исключение
+        MonotonicArena arena;
+        Vector<int, ArenaAllocator<int>> v{ ArenaAllocator<int>(arena) };
+        try
+        {
+            v.Reserve(static_cast<size_t>(-1) / sizeof(int));
+            assert(false);
+        }
+        catch (const std::bad_alloc&)
+        {
+        }
+        assert(v.Capacity() == 0 && arena.BytesReserved() == 0);
+    }
+    {
+        // Блок пула расширяется в пределах своего класса размеров
+        PoolResource pool;
+        Vector<char, PoolAllocator<char>> v{ PoolAllocator<char>(pool) };
+        v.PushBack('a');
+        const char* data = &v[0];
+        v.Reserve(PoolResource::MIN_CLASS_SIZE);
+        assert(&v[0] == data);
+        v.Reserve(PoolResource::MIN_CLASS_SIZE + 1);
+        assert(v[0] == 'a');
+    }
+    {
+        Vector<int, MallocAllocator<int>> v;
+        v.PushBack(1);
+        for (size_t i = 1; i < SIZE; ++i)
+        {
+            // Аргумент ссылается на элемент вектора и должен пережить realloc
+            v.PushBack(v[i - 1]);
+            v[i] += 1;
+        }
+        v.Emplace(v.cbegin(), v[SIZE - 1]);
+        v.Reserve(SIZE * 4);
+        assert(v.Size() == SIZE + 1);
+        assert(v[0] == static_cast<int>(SIZE));
+        assert(v[SIZE] == static_cast<int>(SIZE));
+    }
+    {
+        RelocatableHandle::num_moved = 0;
+        Vector<RelocatableHandle, MallocAllocator<RelocatableHandle>> v;
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        assert(RelocatableHandle::num_moved == 0);
+        assert(*v[SIZE - 1].ptr == static_cast<int>(SIZE - 1));
+    }
+}
+
+void Test10()
+{
+    {
+        Vector<int, std::allocator<int>, OneAndHalfGrowth> v;
+        std::vector<size_t> capacities;
+        for (int i = 0; i < 20; ++i)
+        {
+            v.PushBack(i);
+            if (capacities.empty() || capacities.back() != v.Capacity())
+            {
+                capacities.push_back(v.Capacity());
+            }
+        }
+        assert((capacities == std::vector<size_t>{ 1, 2, 3, 5, 8, 12, 18, 27 }));
     }
+    {
+        Vector<int, std::allocator<int>, MinCapacityGrowth<>> v;
+        v.EmplaceBack(1);
+        assert(v.Capacity() == 64 / sizeof(int));
+        Vector<Obj, std::allocator<Obj>, MinCapacityGrowth<>> v_obj;
+        v_obj.Emplace(v_obj.cend(), 1);
+        assert(v_obj.Capacity() == std::max<size_t>(1, 64 / sizeof(Obj)));
+    }
+    {
+        PoolResource pool;
+        Vector<char, PoolAllocator<char>, SizeClassGrowth<>> v{ PoolAllocator<char>(pool) };
+        v.PushBack('a');
+        assert(v.Capacity() == PoolResource::MIN_CLASS_SIZE);
+        Vector<char, std::allocator<char>, SizeClassGrowth<OneAndHalfGrowth>> v_pow2;
+        for (int i = 0; i < 5; ++i)
+        {
+            v_pow2.PushBack('a');
+        }
+        assert(v_pow2.Capacity() == 8);
+    }
+}
 
-    static void Reset()
+void Test11()
+{
+    const size_t N = 8;
+    const int ID = 42;
     {
-        def_ctor = 0;
-        copy_ctor = 0;
-        move_ctor = 0;
-        copy_assign = 0;
-        move_assign = 0;
-        dtor = 0;
+        Obj::ResetCounters();
+        SmallVector<Obj, N> v;
+        assert(v.Capacity() == N);
+        assert(v.IsInline());
+        for (size_t i = 0; i < N; ++i)
+        {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        assert(v.IsInline());
+        v.Emplace(v.cbegin() + 1, ID);
+        assert(!v.IsInline());
+        assert(v.Size() == N + 1);
+        assert(v[1].id == ID);
+        assert(v[N].id == static_cast<int>(N - 1));
+        v.Erase(v.cbegin() + 1);
+        assert(v[1].id == 1);
+
+        assert(!v.IsInline());
+
+        // Копия помещается во встроенный буфер, даже если оригинал в куче
+        SmallVector<Obj, N> v_copy(v);
+        assert(v_copy.IsInline());
+        assert(v_copy.Size() == N);
+        v_copy.Resize(2);
+        SmallVector<Obj, N> v_small(v_copy);
+        assert(v_small.IsInline());
+        assert(v_small[1].id == 1);
+
+        SmallVector<Obj, N> v_moved(std::move(v_small));
+        assert(v_moved.IsInline());
+        assert(v_moved.Size() == 2);
+        v_moved.Swap(v);
+        assert(v_moved.Size() == N);
+        assert(v.Size() == 2);
+        assert(v[1].id == 1);
+        v = v_moved;
+        assert(v.Size() == N);
+        assert(v[N - 1].id == static_cast<int>(N - 1));
     }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Буфер в куче перемещается без перемещения элементов
+        Obj::ResetCounters();
+        SmallVector<Obj, N> v(N + 1);
+        SmallVector<Obj, N> v_assigned(2);
+        assert(!v.IsInline());
+        const Obj* data = v.Data();
+        const int old_num_moved = Obj::num_moved;
+        SmallVector<Obj, N> v_moved(std::move(v));
+        assert(v_moved.Data() == data && v_moved.Size() == N + 1);
+        assert(v.IsInline() && v.Size() == 0 && v.Capacity() == N);
 
-    inline static size_t def_ctor = 0;
-    inline static size_t copy_ctor = 0;
-    inline static size_t move_ctor = 0;
-    inline static size_t copy_assign = 0;
-    inline static size_t move_assign = 0;
-    inline static size_t dtor = 0;
-};
+        v_assigned = std::move(v_moved);
+        assert(v_assigned.Data() == data && v_assigned.Size() == N + 1);
+        assert(v_moved.IsInline() && v_moved.Size() == 0);
+        assert(Obj::num_moved == old_num_moved && Obj::num_copied == 0);
+        v_moved.EmplaceBack(ID);
+        v_moved.Swap(v_assigned);
+        assert(v_moved.Data() == data && v_assigned.IsInline() && v_assigned[0].id == ID);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    // Vector<SmallVector> перемещает элементы при росте, а не копирует их
+    static_assert(std::is_nothrow_move_constructible_v<SmallVector<Obj, N>>);
+    // Связать SmallVector со ссылкой на Vector нельзя: Vector мог бы забрать встроенный буфер
+    static_assert(!std::is_convertible_v<SmallVector<Obj, 4>&, Vector<Obj, SmallBufferAllocator<Obj, 4>>&>);
+    {
+        // Исключение при переходе в кучу не теряет элементы встроенного буфера
+        Obj::ResetCounters();
+        SmallVector<Obj, 2> v(2);
+        v[0].throw_on_copy = true;
+        try
+        {
+            SmallVector<Obj, 2> v_copy(v);
+            assert(false && "Exception is expected");
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+        assert(v.Size() == 2);
+        assert(Obj::GetAliveObjectCount() == 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test12()
+{
+    const size_t SIZE = 10;
+    const int ID = 42;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        std::vector<Obj> source;
+        for (int i = 1; i <= 5; ++i)
+        {
+            source.emplace_back(i);
+        }
+        const int old_num_moved = Obj::num_moved;
+        auto pos = v.Insert(v.cbegin() + 2, source.begin(), source.end());
+        assert(pos == v.begin() + 2);
+        assert(v.Size() == SIZE + 5);
+        assert(v.Capacity() == SIZE * 2);
+        assert(v[0].id == 0 && v[1].id == 0);
+        for (int i = 0; i < 5; ++i)
+        {
+            assert(v[2 + i].id == i + 1);
+        }
+        assert(v[7].id == 0);
+        // Одна реаллокация: каждый старый элемент перемещён ровно один раз
+        assert(Obj::num_copied == 5);
+        assert(Obj::num_moved == old_num_moved + static_cast<int>(SIZE));
+
+        // Вставка помещается в текущую вместимость
+        const int old_num_copied = Obj::num_copied;
+        v.Insert(v.cbegin() + 1, 3, Obj{ ID });
+        assert(v.Size() == SIZE + 8);
+        assert(v.Capacity() == SIZE * 2);
+        assert(v[1].id == ID && v[3].id == ID && v[4].id == 0);
+        assert(v[5].id == 1);
+        assert(Obj::num_copied == old_num_copied + 4);
+
+        // Исключение при копировании оставляет вектор прежним
+        source[3].throw_on_copy = true;
+        const size_t old_capacity = v.Capacity();
+        try
+        {
+            v.Insert(v.cbegin() + 1, source.begin(), source.end());
+            assert(false && "Exception is expected");
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+        assert(v.Size() == SIZE + 8);
+        assert(v.Capacity() == old_capacity);
+        assert(v[1].id == ID && v[5].id == 1);
+        try
+        {
+            // То же при вставке с реаллокацией
+            v.Insert(v.cbegin() + 1, source.begin(), source.begin() + 3);
+            assert(v.Size() == old_capacity + 1);
+            v.Insert(v.cbegin() + 1, source.begin(), source.end());
+            assert(false && "Exception is expected");
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+        assert(v.Size() == SIZE + 11);
+        assert(v.Capacity() == old_capacity * 2);
+        assert(v[1].id == 1 && v[3].id == 3 && v[4].id == ID);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Vector<int> v;
+        v.Append({ 1, 2, 3 });
+        v.Insert(v.cbegin() + 1, { 7, 8 });
+        v.Insert(v.cbegin(), size_t{ 2 }, v[4]);
+        std::istringstream input("4 5 6");
+        v.Append(std::istream_iterator<int>(input), std::istream_iterator<int>());
+        std::istringstream input_middle("9");
+        v.Insert(v.cbegin() + 1, std::istream_iterator<int>(input_middle), std::istream_iterator<int>());
+        const std::vector<int> expected{ 3, 9, 3, 1, 7, 8, 2, 3, 4, 5, 6 };
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+    }
+}
+
+void Test13()
+{
+    const size_t SIZE = 10;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        for (int i = 0; i < static_cast<int>(SIZE); ++i)
+        {
+            v.EmplaceBack(i);
+        }
+        auto pos = v.Erase(v.cbegin() + 2, v.cbegin() + 5);
+        assert(pos == v.begin() + 2);
+        assert(v.Size() == SIZE - 3);
+        assert(v[1].id == 1 && v[2].id == 5 && v[SIZE - 4].id == static_cast<int>(SIZE - 1));
+        assert(Obj::num_move_assigned == SIZE - 5);
+        assert(Obj::GetAliveObjectCount() == SIZE - 3);
+        v.Erase(v.cbegin(), v.cbegin());
+        assert(v.Size() == SIZE - 3);
+
+        const size_t removed = EraseIf(v, [](const Obj& obj)
+                                       {
+                                           return obj.id % 2 == 1;
+                                       });
+        assert(removed == 4);
+        assert(v.Size() == 3);
+        assert(v[0].id == 0 && v[1].id == 6 && v[2].id == 8);
+        v.Erase(v.cbegin(), v.cend());
+        assert(v.Size() == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Vector<int> v;
+        v.Append({ 1, 2, 1, 3, 1 });
+        assert(Erase(v, 1) == 3);
+        assert(v.Size() == 2 && v[0] == 2 && v[1] == 3);
+        SmallVector<int, 4> small;
+        small.Append({ 5, 5, 6 });
+        assert(Erase(small, 5) == 2);
+        assert(small.Size() == 1 && small[0] == 6);
+    }
+}
 
-void Dump()
+void Test14()
 {
-    using namespace std;
-    cerr << "Def ctors: "sv << C::def_ctor              //
-        << ", Copy ctors: "sv << C::copy_ctor          //
-        << ", Move ctors: "sv << C::move_ctor          //
-        << ", Copy assignments: "sv << C::copy_assign  //
-        << ", Move assignments: "sv << C::move_assign  //
-        << ", Dtors: "sv << C::dtor << endl;
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE, default_init);
+        assert(v.Size() == SIZE);
+        assert(Obj::num_default_constructed == SIZE);
+        v.ResizeDefaultInit(SIZE * 2);
+        assert(v.Size() == SIZE * 2);
+        assert(v.Capacity() == SIZE * 2);
+        assert(Obj::num_default_constructed == SIZE * 2);
+        v.ResizeDefaultInit(1);
+        assert(Obj::GetAliveObjectCount() == 1);
+    }
+    {
+        Vector<char> v(4, default_init);
+        v[0] = 'a';
+        v.ResizeAndOverwrite(SIZE, [](char* data, size_t n)
+                             {
+                                 assert(data[0] == 'a');
+                                 const std::string_view text = "hello";
+                                 assert(text.size() <= n);
+                                 std::copy(text.begin(), text.end(), data + 1);
+                                 return text.size() + 1;
+                             });
+        assert(v.Size() == 6);
+        assert(v.Capacity() == SIZE);
+        assert(std::string(v.begin(), v.end()) == "ahello");
+        v.ResizeAndOverwrite(2, [](char* /*data*/, size_t n)
+                             {
+                                 return n;
+                             });
+        assert(std::string(v.begin(), v.end()) == "ah");
+    }
 }
 
-void Benchmark()
+void Test15()
 {
-    using namespace std;
-    try
     {
-        const size_t NUM = 10;
-        C c;
+        Vector<float, AlignedAllocator<float, 64>> v;
+        static_assert(RawMemory<float, AlignedAllocator<float, 64>>::ALIGNMENT == 64);
+        for (int i = 0; i < 1000; ++i)
+        {
+            v.PushBack(static_cast<float>(i));
+            assert(reinterpret_cast<uintptr_t>(v.begin()) % 64 == 0);
+        }
+        float sum = 0;
+        for (float value : v)
         {
-            cerr << "std::vector:"sv << endl;
-            C::Reset();
-            vector<C> v(NUM);
-            Dump();
-            v.push_back(c);
+            sum += value;
         }
-        Dump();
+        assert(sum == 999.0f * 1000.0f / 2.0f);
     }
-    catch (...)
     {
+        // Буфер переходит из обычной кучи в mmap и растёт через mremap
+        const size_t SIZE = 3 * HugePageAllocator<int>::LARGE_BUFFER_SIZE / sizeof(int);
+        Vector<int, HugePageAllocator<int>> v;
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            v.PushBack(static_cast<int>(i));
+        }
+        assert(reinterpret_cast<uintptr_t>(v.begin()) % HugePageAllocator<int>::alignment == 0);
+        assert(v[0] == 0);
+        assert(v[SIZE / 2] == static_cast<int>(SIZE / 2));
+        assert(v[SIZE - 1] == static_cast<int>(SIZE - 1));
+        Vector<int, HugePageAllocator<int>> v_copy(v);
+        assert(v_copy[SIZE - 1] == static_cast<int>(SIZE - 1));
+    }
+}
+
+// Проверяется только в сборке с -DVECTOR_ENABLE_STATS
+void Test16()
+{
+#if defined(VECTOR_ENABLE_STATS)
+    struct ThrowingMove
+    {
+        ThrowingMove() = default;
+        ThrowingMove(const ThrowingMove&) = default;
+        ThrowingMove(ThrowingMove&&) noexcept(false) = default;
+
+        std::string name;
+    };
+    struct NothrowMove
+    {
+        int value = 0;
+        std::string name;
+    };
+
+    {
+        Vector<ThrowingMove> v;
+        for (int i = 0; i < 4; ++i)
+        {
+            v.EmplaceBack();
+        }
+        // Емкости 1, 2, 4: три реаллокации, копируются 0 + 1 + 2 элемента
+        const VectorStatsSnapshot stats = GetVectorStats<ThrowingMove>();
+        assert(stats.allocations == 3);
+        assert(stats.deallocations == 2);
+        assert(stats.bytes_allocated == 7 * sizeof(ThrowingMove));
+        assert(stats.growth_events == 3);
+        assert(stats.copied_elements == 3);
+        assert(stats.moved_elements == 0);
+        assert(stats.peak_capacity == 4);
+    }
+    {
+        Vector<NothrowMove> v(10);
+        v.Reserve(100);
+        Vector<int> ints;
+        ints.Resize(10);
+        ints.Reserve(20);
+        const VectorStatsSnapshot stats = GetVectorStats<NothrowMove>();
+        assert(stats.moved_elements == 10);
+        assert(stats.copied_elements == 0);
+        assert(stats.growth_events == 1);
+        assert(GetVectorStats<int>().relocated_elements >= 10);
+
+        // Уменьшение вместимости считается отдельно от роста
+        v.ShrinkToFit();
+        const VectorStatsSnapshot shrunk = GetVectorStats<NothrowMove>();
+        assert(shrunk.growth_events == 1 && shrunk.shrink_events == 1);
+    }
+    const auto all_stats = SnapshotAllVectorStats();
+    assert(std::any_of(all_stats.begin(), all_stats.end(), [](const VectorStatsSnapshot& stats)
+                       {
+                           return stats.copied_elements == 3;
+                       }));
+    ResetVectorStats();
+    assert(GetVectorStats<ThrowingMove>().allocations == 0);
+#endif
+}
+
+void Test17()
+{
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Resize(SIZE / 2);
+        assert(v.Capacity() == SIZE);
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE / 2);
+        assert(v.Size() == SIZE / 2);
+        assert(Obj::num_moved == SIZE / 2);
+        assert(Obj::num_copied == 0);
+        v.Resize(0);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        SmallVector<int, 4> v;
+        v.Append({ 1, 2, 3, 4, 5 });
+        assert(!v.IsInline());
+        v.PopBack();
+        v.ShrinkToFit();
+        assert(v.IsInline());
+        assert(v.Size() == 4 && v[3] == 4);
+    }
+    {
+        // Вместимость SmallVector не опускается ниже N
+        SmallVector<int, 8> v;
+        v.Append({ 1, 2, 3 });
+        v.ShrinkToFit();
+        assert(v.IsInline() && v.Capacity() == 8);
+        v.Append({ 4, 5, 6, 7, 8, 9 });
+        assert(!v.IsInline());
+        v.Erase(v.cbegin() + 3, v.cend());
+        v.ShrinkToFit();
+        assert(v.IsInline() && v.Capacity() == 8);
+        assert(v.Size() == 3 && v[2] == 3);
+    }
+    {
+        SmallVector<int, 32, std::allocator<int>, ShrinkingGrowth<>> v;
+        v.Append({ 1, 2, 3, 4, 5 });
+        v.Resize(3);
+        assert(v.IsInline() && v.Capacity() == 32);
+        for (int i = 0; i < 100; ++i)
+        {
+            v.PushBack(i);
+        }
+        assert(!v.IsInline());
+        v.Resize(2);
+        assert(v.IsInline() && v.Capacity() == 32);
+        assert(v[0] == 1 && v[1] == 2);
+    }
+    {
+        SmallVector<int, 4, std::allocator<int>, ShrinkingGrowth<>> v;
+        for (int i = 0; i < 100; ++i)
+        {
+            v.PushBack(i);
+        }
+        while (v.Size() > 2)
+        {
+            v.PopBack();
+        }
+        assert(v.IsInline() && v.Capacity() == 4);
+        assert(v[1] == 1);
+    }
+    {
+        Vector<int, std::allocator<int>, ShrinkingGrowth<>> v;
+        for (int i = 0; i < 1024; ++i)
+        {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() == 1024);
+        while (v.Size() > 256)
+        {
+            v.PopBack();
+        }
+        assert(v.Capacity() == 1024);
+        v.PopBack();
+        assert(v.Capacity() == 510);
+        // Колебания размера около порога не вызывают реаллокаций
+        for (int i = 0; i < 100; ++i)
+        {
+            v.PushBack(i);
+            v.PopBack();
+            v.PopBack();
+            v.PushBack(i);
+        }
+        assert(v.Capacity() == 510);
+        v.Erase(v.cbegin(), v.cbegin() + 200);
+        assert(v.Capacity() == 110);
+        assert(v[0] == 200);
+        v.Resize(3);
+        assert(v.Capacity() == 16);
+        assert(v[2] == 202);
+    }
+}
+
+void Test18()
+{
+    const size_t SIZE = 1000;
+    {
+        Obj::ResetCounters();
+        SegmentedVector<Obj, 16> v;
+        v.EmplaceBack(0);
+        Obj* first = &v[0];
+        for (size_t i = 1; i < SIZE; ++i)
+        {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        // Рост не перемещает элементы, ссылки остаются действительными
+        assert(&v[0] == first);
+        assert(Obj::num_moved == 0 && Obj::num_copied == 0);
+        assert(v.Size() == SIZE);
+        assert(v.Capacity() == 1008);
+        assert(std::distance(v.begin(), v.end()) == static_cast<std::ptrdiff_t>(SIZE));
+        assert((v.begin() + 500)->id == 500);
+        assert(v.cend()[-1].id == static_cast<int>(SIZE - 1));
+        v.PopBack();
+        assert(Obj::GetAliveObjectCount() == SIZE - 1);
+
+        SegmentedVector<Obj, 16> copy(v);
+        assert(copy.Size() == SIZE - 1);
+        assert(Obj::num_copied == SIZE - 1);
+        SegmentedVector<Obj, 16> moved(std::move(copy));
+        assert(moved.Size() == SIZE - 1 && copy.Size() == 0);
+        assert(std::equal(v.begin(), v.end(), moved.begin(), [](const Obj& lhs, const Obj& rhs) {
+            return lhs.id == rhs.id;
+        }));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        SegmentedVector<int> v;
+        static_assert(SegmentedVector<int>::SegmentSize() == 1024);
+        v.Reserve(3000);
+        assert(v.Capacity() == 3072);
+        for (int i = 0; i < 3000; ++i)
+        {
+            v.PushBack(3000 - i);
+        }
+        std::sort(v.begin(), v.end());
+        assert(std::is_sorted(v.cbegin(), v.cend()));
+        assert(v[0] == 1 && v[2999] == 3000);
+    }
+}
+
+void Test19()
+{
+    const size_t THREADS = 4;
+    const size_t PER_THREAD = 10000;
+    {
+        ConcurrentVector<std::string> v;
+        std::string& first = v.EmplaceBack("first");
+        std::vector<std::thread> writers;
+        for (size_t t = 0; t < THREADS; ++t)
+        {
+            writers.emplace_back([&v, t] {
+                for (size_t i = 0; i < PER_THREAD; ++i)
+                {
+                    v.PushBack(std::to_string(t * PER_THREAD + i));
+                }
+            });
+        }
+        // Читатель обходит опубликованный префикс одновременно с писателями
+        size_t max_seen = 0;
+        while (max_seen < THREADS * PER_THREAD + 1)
+        {
+            size_t count = 0;
+            for (const std::string& s : v)
+            {
+                assert(!s.empty());
+                ++count;
+            }
+            assert(count >= max_seen);
+            max_seen = count;
+        }
+        for (std::thread& writer : writers)
+        {
+            writer.join();
+        }
+        assert(v.Size() == THREADS * PER_THREAD + 1);
+        assert(&v[0] == &first && first == "first");
+
+        std::vector<bool> seen(THREADS * PER_THREAD);
+        for (size_t i = 1; i < v.Size(); ++i)
+        {
+            const size_t value = std::stoul(v[i]);
+            assert(!seen[value]);
+            seen[value] = true;
+        }
+    }
+    {
+        Obj::ResetCounters();
+        {
+            ConcurrentVector<Obj, std::allocator<Obj>, 4> v;
+            v.Reserve(100);
+            for (int i = 0; i < 100; ++i)
+            {
+                v.EmplaceBack(i);
+            }
+            assert(Obj::GetAliveObjectCount() == 100);
+            // Конструктор Obj(int) может бросать, поэтому элемент создаётся до захвата ячейки и перемещается
+            assert(Obj::num_moved == 100 && Obj::num_copied == 0);
+            assert(v[99].id == 99);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Сегмент выделяется до захвата ячейки: нехватка памяти не оставляет пустой ячейки
+        ConcurrentVector<int, FailingAllocator<int>, 4> v;
+        for (int i = 0; i < 4; ++i)
+        {
+            v.EmplaceBack(i);
+        }
+        fail_allocations = true;
+        try
+        {
+            v.EmplaceBack(4);
+            assert(false);
+        }
+        catch (const std::bad_alloc&)
+        {
+        }
+        fail_allocations = false;
+        assert(v.Size() == 4);
+        v.EmplaceBack(4);
+        assert(v.Size() == 5 && v[4] == 4);
+    }
+}
+
+void Test21()
+{
+    {
+        Obj::ResetCounters();
+        SoaVector<int, double, Obj> v;
+        for (int i = 0; i < 100; ++i)
+        {
+            v.EmplaceBack(i, i * 0.5, i);
+        }
+        assert(v.Size() == 100);
+        assert(v.Capacity() == 128);
+        assert(Obj::GetAliveObjectCount() == 100);
+
+        // Столбцы непрерывны и обходятся независимо
+        SoaColumn<int> ids = v.Column<0>();
+        assert(ids.Size() == 100);
+        assert(ids.Data() + 99 == &ids[99]);
+        long long sum = 0;
+        for (int id : ids)
+        {
+            sum += id;
+        }
+        assert(sum == 4950);
+        assert(v.Get<1>(10) == 5.0);
+        assert(v.Get<2>(42).id == 42);
+
+        // Запись может ссылаться на элементы самого контейнера и при росте
+        v.Reserve(100);
+        assert(v.Capacity() == 128);
+        while (v.Size() < v.Capacity())
+        {
+            v.EmplaceBack(v.Get<0>(0), v.Get<1>(0), v.Get<2>(0));
+        }
+        v.EmplaceBack(v.Get<0>(99), v.Get<1>(99), v.Get<2>(99));
+        assert(v.Capacity() == 256);
+        assert(v.Get<0>(128) == 99 && v.Get<2>(128).id == 99);
+
+        int expected = 0;
+        for (auto [id, half, obj] : v)
+        {
+            if (expected == 100)
+            {
+                break;
+            }
+            assert(id == expected && half == expected * 0.5 && obj.id == expected);
+            obj.id = -id;
+            ++expected;
+        }
+        assert(v.Get<2>(7).id == -7);
+        std::get<1>(*(v.begin() + 3)) = 42.0;
+        assert(v.Get<1>(3) == 42.0);
+
+        const SoaVector<int, double, Obj> copy(v);
+        assert(copy.Size() == v.Size());
+        assert(std::get<2>(copy[7]).id == -7);
+        assert(copy.cend() - copy.cbegin() == static_cast<std::ptrdiff_t>(copy.Size()));
+        assert(copy.cbegin() < copy.cend() && copy.cend() > copy.cbegin());
+        assert(copy.cbegin() <= copy.cbegin() && copy.cend() >= copy.cbegin());
+        assert(2 + copy.cbegin() == copy.cbegin() + 2);
+        assert(std::distance(copy.cbegin(), copy.cend()) == static_cast<std::ptrdiff_t>(copy.Size()));
+
+        v.Resize(10);
+        assert(v.Size() == 10);
+        v.Resize(12);
+        assert(v.Get<0>(11) == 0 && v.Get<1>(11) == 0.0 && v.Get<2>(11).id == 0);
+        v.PopBack();
+        assert(v.Size() == 11);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Исключение при создании поля не меняет контейнер
+        Obj::ResetCounters();
+        SoaVector<std::string, Obj> v;
+        v.EmplaceBack("a", 1);
+        Obj throwing(2);
+        throwing.throw_on_copy = true;
+        try
+        {
+            v.EmplaceBack("b", throwing);
+            assert(false);
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+        assert(v.Size() == 1 && v.Get<0>(0) == "a" && v.Get<1>(0).id == 1);
+        assert(Obj::GetAliveObjectCount() == 2);
+    }
+    {
+        // Исключение при копировании столбца во время роста не трогает
+        // столбцы, которые переносятся перемещением
+        SoaVector<std::string, ThrowingCopy> v;
+        for (int i = 0; i < 4; ++i)
+        {
+            v.EmplaceBack(std::string(32, static_cast<char>('a' + i)), i);
+        }
+        assert(v.Size() == v.Capacity());
+        v.Get<1>(2).throw_on_copy = true;
+        try
+        {
+            v.EmplaceBack("e", 4);
+            assert(false);
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+        assert(v.Size() == 4 && v.Capacity() == 4);
+        for (int i = 0; i < 4; ++i)
+        {
+            assert(v.Get<0>(i) == std::string(32, static_cast<char>('a' + i)));
+            assert(v.Get<1>(i).value == i);
+        }
+    }
+}
+
+void Test22()
+{
+    {
+        Vector<int> v;
+        assert(v.Data() == nullptr);
+        assert(v.Data() == v.begin());
+        v.Reserve(4);
+        assert(v.Data() != nullptr && v.Size() == 0);
+        v.Append({ 1, 2, 3 });
+        assert(v.Data() == &v[0]);
+        const Vector<int>& cv = v;
+        assert(cv.Data() == cv.cbegin());
+    }
+#if defined(__cpp_lib_span) && defined(__cpp_lib_ranges)
+    {
+        static_assert(std::ranges::contiguous_range<Vector<int>>);
+        static_assert(std::ranges::sized_range<Vector<int>>);
+        static_assert(std::ranges::contiguous_range<const Vector<std::string>>);
+        static_assert(std::contiguous_iterator<Vector<int>::iterator>);
+
+        Vector<int> v;
+        assert(v.AsSpan().empty() && v.AsBytes().empty());
+        v.Append({ 3, 1, 2 });
+        std::span<int> span = v.AsSpan();
+        assert(span.data() == v.Data() && span.size() == 3);
+        assert(v.AsBytes().size() == 3 * sizeof(int));
+        v.AsWritableBytes()[0] = std::byte{ 0 };
+        assert(std::ranges::data(v) == v.Data());
+        std::ranges::sort(v);
+        assert(v[0] == 0 && v[2] == 2);
+        std::span<const int> from_range(v);
+        assert(from_range.size() == 3);
+
+        SoaVector<int, double> soa;
+        soa.EmplaceBack(1, 2.0);
+        std::span<double> column = soa.Column<1>();
+        assert(column.size() == 1 && column[0] == 2.0);
+    }
+#endif
+}
+
+void Test23()
+{
+    {
+        Obj::ResetCounters();
+        Vector<Obj> source;
+        source.Reserve(8);
+        for (int i = 0; i < 5; ++i)
+        {
+            source.EmplaceBack(i);
+        }
+        const Obj* address = source.Data();
+
+        VectorBuffer<Obj> buffer = source.Release();
+        assert(source.Size() == 0 && source.Capacity() == 0 && source.Data() == nullptr);
+        assert(buffer.data == address && buffer.size == 5 && buffer.capacity == 8);
+        assert(Obj::GetAliveObjectCount() == 5);
+
+        // Буфер переходит к другому вектору без копирования и перемещения элементов
+        Vector<Obj> target(2);
+        target.Adopt(buffer);
+        assert(target.Data() == address && target.Size() == 5 && target.Capacity() == 8);
+        assert(target[4].id == 4);
+        assert(Obj::num_copied == 0 && Obj::num_moved == 0);
+        assert(Obj::GetAliveObjectCount() == 5);
+        target.EmplaceBack(5);
+        assert(target.Data() == address);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Буфер, выделенный вне Vector тем же аллокатором
+        std::allocator<int> alloc;
+        int* data = alloc.allocate(4);
+        data[0] = 7;
+        data[1] = 8;
+        Vector<int> v;
+        v.Adopt(data, 2, 4);
+        v.PushBack(9);
+        assert(v.Data() == data && v[2] == 9);
+        VectorBuffer<int> buffer = v.Release();
+        assert(buffer.size == 3 && buffer.capacity == 4);
+        alloc.deallocate(buffer.data, buffer.capacity);
+    }
+}
+
+void Test24()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct Record
+    {
+        int64_t key;
+        double value;
+    };
+    const std::string path = "/tmp/advanced_vector_test24_" + std::to_string(getpid()) + ".bin";
+    std::remove(path.c_str());
+    const size_t SIZE = 10000;
+    {
+        // Буфер в отображении файла нельзя передать другому Vector
+        static_assert(!std::is_convertible_v<PersistentVector<Record>&,
+                                             Vector<Record, MappedFileAllocator<Record>>&>);
+        PersistentVector<Record> v(path);
+        assert(v.IsOpen() && v.Size() == 0);
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            v.PushBack(Record{ static_cast<int64_t>(i), i * 0.5 });
+        }
+        assert(v.Capacity() >= SIZE);
+        v.Flush();
+        v.PushBack(Record{ -1, -1.0 });
+        v.PopBack();
+    }
+    {
+        // После повторного открытия элементы доступны без десериализации
+        PersistentVector<Record> v(path);
+        assert(v.Size() == SIZE);
+        assert(v.Capacity() >= SIZE);
+        assert(v[1234].key == 1234 && v[1234].value == 617.0);
+        assert(v.Data() == &v[0] && v.Data()[SIZE - 1].key == static_cast<int64_t>(SIZE - 1));
+        v.Resize(SIZE / 2);
+        v.Reserve(SIZE * 4);
+        assert(v[SIZE / 2 - 1].key == static_cast<int64_t>(SIZE / 2 - 1));
+        v.Close();
+        assert(!v.IsOpen() && v.Size() == 0);
+        v.Open(path);
+        assert(v.Size() == SIZE / 2 && v.Capacity() == SIZE * 4);
+    }
+    {
+        // Assign за пределы вместимости расширяет единственный буфер файла
+        const std::string assign_path = path + ".assign";
+        std::remove(assign_path.c_str());
+        {
+            PersistentVector<int> v(assign_path);
+            v.Append({ 1, 2 });
+            v.Reserve(2);
+            std::vector<int> source(100);
+            std::iota(source.begin(), source.end(), 0);
+            v.Assign(source.begin(), source.end());
+            assert(v.Size() == 100 && v[99] == 99);
+            v.Assign(500, 3);
+            assert(v.Size() == 500 && v[0] == 3 && v[499] == 3);
+            v.Assign(1000, v[10]);
+            assert(v.Size() == 1000 && v[999] == 3);
+        }
+        PersistentVector<int> reopened(assign_path);
+        assert(reopened.Size() == 1000 && reopened[999] == 3);
+        reopened.Close();
+        std::remove(assign_path.c_str());
+    }
+    {
+        // Файл создан для элементов другого размера
+        PersistentVector<int> v;
+        try
+        {
+            v.Open(path);
+            assert(false);
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+        assert(!v.IsOpen());
+    }
+    std::remove(path.c_str());
+#endif
+}
+
+void Test25()
+{
+    Vector<uint32_t> source;
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        source.PushBack(i * i);
+    }
+    {
+        std::stringstream stream;
+        WriteTo(source, stream);
+        assert(stream.str().size() == sizeof(VectorFileHeader) + 1000 * sizeof(uint32_t));
+        Vector<uint32_t> loaded;
+        ReadFrom(loaded, stream);
+        assert(loaded.Size() == 1000);
+        assert(std::equal(loaded.begin(), loaded.end(), source.begin()));
+    }
+    {
+        // Повреждённые данные, чужой размер элемента и обрыв потока не меняют вектор
+        std::stringstream stream;
+        WriteTo(source, stream);
+        std::string bytes = stream.str();
+        bytes[sizeof(VectorFileHeader) + 10] ^= 1;
+        Vector<uint32_t> loaded(3);
+        std::istringstream corrupted(bytes);
+        bool has_thrown = false;
+        try
+        {
+            ReadFrom(loaded, corrupted);
+        }
+        catch (const std::runtime_error&)
+        {
+            has_thrown = true;
+        }
+        assert(has_thrown && loaded.Size() == 3 && loaded[0] == 0);
+
+        Vector<uint16_t> wrong_type;
+        std::istringstream intact(stream.str());
+        has_thrown = false;
+        try
+        {
+            ReadFrom(wrong_type, intact);
+        }
+        catch (const std::runtime_error&)
+        {
+            has_thrown = true;
+        }
+        assert(has_thrown && wrong_type.Size() == 0);
+
+        std::istringstream truncated(stream.str().substr(0, 100));
+        has_thrown = false;
+        try
+        {
+            ReadFrom(loaded, truncated);
+        }
+        catch (const std::runtime_error&)
+        {
+            has_thrown = true;
+        }
+        assert(has_thrown && loaded.Size() == 3);
+    }
+#if defined(__unix__) || defined(__APPLE__)
+    {
+        const std::string path = "/tmp/advanced_vector_test25_" + std::to_string(getpid()) + ".bin";
+        const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        assert(fd >= 0);
+        WriteTo(source, fd);
+        WriteTo(Vector<uint32_t>(), fd);
+        lseek(fd, 0, SEEK_SET);
+        Vector<uint32_t> loaded;
+        ReadFrom(loaded, fd);
+        assert(loaded.Size() == 1000 && loaded[999] == 999u * 999u);
+        ReadFrom(loaded, fd);
+        assert(loaded.Size() == 0);
+        close(fd);
+        std::remove(path.c_str());
+    }
+#endif
+}
+
+struct C
+{
+    C() noexcept
+    {
+        ++def_ctor;
+    }
+    C(const C& /*other*/) noexcept
+    {
+        ++copy_ctor;
+    }
+    C(C&& /*other*/) noexcept
+    {
+        ++move_ctor;
+    }
+    C& operator=(const C& other) noexcept
+    {
+        if (this != &other)
+        {
+            ++copy_assign;
+        }
+        return *this;
+    }
+    C& operator=(C&& /*other*/) noexcept
+    {
+        ++move_assign;
+        return *this;
+    }
+    ~C()
+    {
+        ++dtor;
+    }
+
+    static void Reset()
+    {
+        def_ctor = 0;
+        copy_ctor = 0;
+        move_ctor = 0;
+        copy_assign = 0;
+        move_assign = 0;
+        dtor = 0;
+    }
+
+    inline static size_t def_ctor = 0;
+    inline static size_t copy_ctor = 0;
+    inline static size_t move_ctor = 0;
+    inline static size_t copy_assign = 0;
+    inline static size_t move_assign = 0;
+    inline static size_t dtor = 0;
+};
+
+// Вставка внутрь вектора без реаллокации создаёт элемент прямо в освобождённой ячейке
+void Test26()
+{
+    {
+        Vector<C> v(3);
+        v.Reserve(8);
+        C::Reset();
+        v.Emplace(v.begin() + 1);
+        assert(v.Size() == 4);
+        // Сдвиг хвоста: последний элемент перемещается в новую ячейку, остальные — присваиванием
+        assert(C::def_ctor == 1);
+        assert(C::move_ctor == 1);
+        assert(C::move_assign == 1);
+        assert(C::dtor == 1);
+        assert(C::copy_ctor == 0 && C::copy_assign == 0);
+    }
+    {
+        Vector<C> v(4);
+        v.Reserve(8);
+        const C value;
+        C::Reset();
+        v.Insert(v.begin(), value);
+        assert(C::copy_ctor == 1 && C::copy_assign == 0);
+        assert(C::move_ctor == 1 && C::move_assign == 3);
+        assert(C::def_ctor == 0 && C::dtor == 1);
+
+        C::Reset();
+        v.Insert(v.begin() + 2, C{});
+        assert(C::def_ctor == 1 && C::copy_ctor == 0);
+        assert(C::move_ctor == 2 && C::move_assign == 2);
+        assert(C::dtor == 2);
+    }
+    {
+        // Вставка элемента самого вектора: после сдвига он берётся с нового места
+        Vector<std::string> v;
+        v.Reserve(8);
+        v.Append({ "a", "b", "c" });
+        v.Insert(v.begin(), v[1]);
+        v.Insert(v.begin() + 3, v[1]);
+        v.Insert(v.begin() + 1, std::move(v[4]));
+        const std::string expected[] = { "b", "c", "a", "b", "a", "" };
+        assert(std::equal(v.begin(), v.end(), std::begin(expected), std::end(expected)));
+        const std::string* data = v.Data();
+        v.Emplace(v.begin(), 3, 'x');
+        assert(v.Data() == data);
+        assert(v[0] == "xxx" && v.Size() == 7);
+    }
+    {
+        Vector<int> v;
+        v.Reserve(8);
+        v.Append({ 1, 2, 3 });
+        v.Insert(v.begin(), v[2]);
+        v.Emplace(v.begin() + 2, v[v.Size() - 1]);
+        const int expected[] = { 3, 1, 3, 2, 3 };
+        assert(std::equal(v.begin(), v.end(), std::begin(expected), std::end(expected)));
+    }
+    {
+        // Числовые аргументы передаются конструктору по ссылке, как есть
+        struct Ref
+        {
+            explicit Ref(int& value)
+                : ptr(&value)
+            {}
+            const int* ptr;
+        };
+        int values[] = { 1, 2, 3 };
+        Vector<Ref> v;
+        v.Reserve(4);
+        v.EmplaceBack(values[0]);
+        v.EmplaceBack(values[2]);
+        v.Emplace(v.begin() + 1, values[1]);
+        assert(v[0].ptr == &values[0] && v[1].ptr == &values[1] && v[2].ptr == &values[2]);
+    }
+    {
+        // Числа внутри сдвигаемых элементов читаются до сдвига
+        Vector<std::pair<int, int>> v;
+        v.Reserve(4);
+        v.EmplaceBack(1, 2);
+        v.EmplaceBack(3, 4);
+        v.Emplace(v.begin(), v[1].first, v[0].second);
+        assert(v.Size() == 3 && v[0] == std::make_pair(3, 2) && v[2] == std::make_pair(3, 4));
+    }
+    {
+        // PushBack создаёт элемент на месте и без Emplace: одна копия или одно перемещение
+        Vector<C> v;
+        v.Reserve(4);
+        const C value;
+        C::Reset();
+        v.PushBack(value);
+        v.PushBack(C{});
+        assert(C::copy_ctor == 1 && C::move_ctor == 1 && C::def_ctor == 1);
+        assert(C::copy_assign == 0 && C::move_assign == 0 && C::dtor == 1);
+    }
+    {
+        // Исключение при создании элемента в освобождённой ячейке возвращает хвост на место
+        Vector<std::string> v;
+        v.Reserve(8);
+        v.Append({ "a", "b", "c" });
+        try
+        {
+            v.Emplace(v.begin() + 1, static_cast<size_t>(-1), 'x');
+            assert(false);
+        }
+        catch (const std::exception&)
+        {
+        }
+        const std::string expected[] = { "a", "b", "c" };
+        assert(std::equal(v.begin(), v.end(), std::begin(expected), std::end(expected)));
+    }
+    {
+        // То же для побитово переносимого типа: перемещение временного объекта в ячейку бросает исключение
+        Vector<ThrowingMoveRelocatable> v;
+        v.Reserve(8);
+        const std::string names[] = { "a", "b", "c" };
+        for (const std::string& name : names)
+        {
+            v.EmplaceBack(name);
+        }
+        ThrowingMoveRelocatable::throw_on_move = true;
+        try
+        {
+            v.Emplace(v.begin() + 1, std::string("x"));
+            assert(false);
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+        ThrowingMoveRelocatable::throw_on_move = false;
+        assert(v.Size() == 3);
+        for (size_t i = 0; i < v.Size(); ++i)
+        {
+            assert(v[i].name == names[i]);
+        }
+    }
+}
+
+// Вставка в конец без проверок вместимости: EmplaceBackUnchecked и BackInserter
+void Test27()
+{
+    {
+        Vector<int> v;
+        v.Reserve(3);
+        const int* data = v.Data();
+        v.EmplaceBackUnchecked(1);
+        v.EmplaceBackUnchecked(2) = 20;
+        assert(v.Size() == 2 && v[1] == 20);
+        assert(v.Data() == data);
+    }
+    {
+        const size_t SIZE = 1000;
+        Vector<int> v;
+        v.PushBack(-1);
+        {
+            auto inserter = v.ReserveBack(SIZE);
+            assert(v.Capacity() >= SIZE + 1);
+            assert(inserter.Remaining() == SIZE);
+            for (size_t i = 0; i < SIZE; ++i)
+            {
+                inserter.PushBack(static_cast<int>(i));
+            }
+            assert(inserter.Remaining() == 0);
+        }
+        assert(v.Size() == SIZE + 1);
+        assert(v[0] == -1 && v[1] == 0 && v[SIZE] == static_cast<int>(SIZE - 1));
+    }
+    {
+        // Вставлено меньше зарезервированного: размер учитывает только созданные элементы
+        Vector<C> v;
+        C::Reset();
+        {
+            auto inserter = v.ReserveBack(10);
+            inserter.EmplaceBack();
+            const C value;
+            inserter.PushBack(value);
+            inserter.PushBack(C{});
+        }
+        assert(v.Size() == 3);
+        assert(C::def_ctor == 3 && C::copy_ctor == 1 && C::move_ctor == 1);
+        assert(C::copy_assign == 0 && C::move_assign == 0);
+    }
+    {
+        // Элементы, созданные до исключения, остаются в векторе
+        Vector<std::string> v;
+        try
+        {
+            auto inserter = v.ReserveBack(3);
+            inserter.EmplaceBack("a");
+            inserter.EmplaceBack(static_cast<size_t>(-1), 'x');
+            assert(false);
+        }
+        catch (const std::exception&)
+        {
+        }
+        assert(v.Size() == 1 && v[0] == "a");
+    }
+}
+
+#if defined(VECTOR_HAS_CONSTEXPR)
+// Таблица, вычисленная Vector на этапе компиляции
+constexpr std::array<int, 16> SQUARES = [] {
+    Vector<int> v;
+    for (int i = 0; i < 16; ++i)
+    {
+        v.PushBack(i * i);
+    }
+    std::array<int, 16> result{};
+    std::copy(v.begin(), v.end(), result.begin());
+    return result;
+}();
+
+constexpr bool TestConstexprVector()
+{
+    Vector<int> v(3);
+    v.EmplaceBack(7);
+    v.Reserve(10);
+    v.Resize(6);
+    v.PopBack();
+    if (v.Size() != 5 || v.Capacity() != 10 || v[3] != 7 || v[4] != 0)
+    {
+        return false;
+    }
+
+    Vector<int> copy = v;
+    Vector<int> small(1);
+    small = v;
+    Vector<int> large(20);
+    large = v;
+    Vector<int> moved = std::move(copy);
+    moved.Swap(small);
+    moved.ShrinkToFit();
+    if (moved.Size() != 5 || moved.Capacity() != 5 || large.Size() != 5 || copy.Size() != 0)
+    {
+        return false;
+    }
+
+    // Элементы нетривиального типа переносятся move-конструктором
+    Vector<Vector<int>> nested;
+    for (int i = 0; i < 10; ++i)
+    {
+        nested.EmplaceBack(static_cast<size_t>(i)).PushBack(i);
+    }
+    Vector<Vector<int>> nested_copy(nested);
+    int sum = 0;
+    for (const Vector<int>& inner : nested_copy)
+    {
+        sum += static_cast<int>(inner.Size());
+    }
+
+    Vector<int, std::allocator<int>, ShrinkingGrowth<>> shrinking(64);
+    while (shrinking.Size() > 1)
+    {
+        shrinking.PopBack();
+    }
+    return sum == 55 && nested[9][9] == 9 && shrinking.Capacity() < 64;
+}
+#endif
+
+// Vector в вычислениях на этапе компиляции (C++20)
+void Test28()
+{
+#if defined(VECTOR_HAS_CONSTEXPR)
+    static_assert(SQUARES[0] == 0 && SQUARES[15] == 225);
+    static_assert(TestConstexprVector());
+    assert(TestConstexprVector());
+#endif
+}
+
+void Test29()
+{
+    {
+        BitVector<> bits;
+        assert(bits.Empty() && bits.FindFirst() == BitVector<>::NPOS);
+        for (size_t i = 0; i < 200; ++i)
+        {
+            bits.PushBack(i % 3 == 0);
+        }
+        assert(bits.Size() == 200 && bits.WordsSize() == 4);
+        assert(bits.Count() == 67);
+        assert(bits[0] && !bits[1] && bits[198] && !bits[199]);
+        bits[1] = true;
+        bits[0] = bits[2];
+        bits.Flip(199);
+        assert(!bits[0] && bits[1] && bits[199]);
+        assert(bits.Count() == 68);
+
+        assert(bits.FindFirst() == 1);
+        assert(bits.FindNext(1) == 3);
+        assert(bits.FindNext(63) == 66);
+        assert(bits.FindNext(198) == 199);
+        assert(bits.FindNext(199) == BitVector<>::NPOS);
+
+        bits.PopBack();
+        assert(bits.Size() == 199 && bits.Count() == 67);
+        // Биты за пределами размера обнуляются и не видны после повторного роста
+        bits.PushBack(false);
+        assert(!bits[199] && bits.Count() == 67);
+    }
+    {
+        BitVector<> bits(70, true);
+        assert(bits.Count() == 70);
+        bits.Resize(130);
+        assert(bits.Count() == 70 && !bits[129]);
+        bits.Resize(140, true);
+        assert(bits.Count() == 80 && bits[139] && !bits[75]);
+        bits.Resize(65);
+        assert(bits.Count() == 65 && bits.WordsSize() == 2);
+        bits.FlipAll();
+        assert(bits.None());
+    }
+    {
+        BitVector<> a(100);
+        BitVector<> b(100);
+        for (size_t i = 0; i < 100; ++i)
+        {
+            a.Set(i, i % 2 == 0);
+            b.Set(i, i % 5 == 0);
+        }
+        BitVector<> both = a;
+        both &= b;
+        assert(both.Count() == 10 && both.FindFirst() == 0 && both.FindNext(0) == 10);
+        BitVector<> either = a;
+        either |= b;
+        assert(either.Count() == 60);
+        BitVector<> diff = a;
+        diff ^= b;
+        assert(diff.Count() == 50);
+        assert(a != b);
+
+        BitVector<> copy;
+        copy = a;
+        assert(copy == a);
+        BitVector<> moved = std::move(copy);
+        assert(moved == a && copy.Empty());
+        moved.Swap(copy);
+        assert(copy == a && moved.Empty());
+    }
+    {
+        // 1 000 000 флагов занимают 125 000 байт вместо 1 000 000
+        BitVector<> flags;
+        flags.Reserve(1'000'000);
+        for (size_t i = 0; i < 1'000'000; ++i)
+        {
+            flags.PushBack(i % 1000 == 999);
+        }
+        assert(flags.WordsSize() * sizeof(uint64_t) == 125'000);
+        assert(flags.Count() == 1000);
+        size_t found = 0;
+        for (size_t i = flags.FindFirst(); i != BitVector<>::NPOS; i = flags.FindNext(i))
+        {
+            assert(i % 1000 == 999);
+            ++found;
+        }
+        assert(found == 1000);
+    }
+}
+
+// Уровни SIMD, которые можно выполнить на этом процессоре
+std::vector<VectorSimdLevel> SupportedSimdLevels()
+{
+    const VectorSimdLevel detected = GetVectorSimdLevel();
+    std::vector<VectorSimdLevel> levels{ VectorSimdLevel::SCALAR };
+    if (detected == VectorSimdLevel::NEON)
+    {
+        levels.push_back(detected);
+    }
+    for (VectorSimdLevel level : { VectorSimdLevel::SSE2, VectorSimdLevel::AVX2, VectorSimdLevel::AVX512 })
+    {
+        if (detected != VectorSimdLevel::NEON && detected >= level)
+        {
+            levels.push_back(level);
+        }
+    }
+    return levels;
+}
+
+template <typename T>
+void TestSimdKernels()
+{
+    using Simd = VectorSimd<T>;
+    for (VectorSimdLevel level : SupportedSimdLevels())
+    {
+        // Размеры вокруг границ регистров и блоков, смещение проверяет невыровненные данные
+        for (size_t n : { 0, 1, 3, 7, 8, 15, 16, 31, 33, 64, 127, 130, 1000 })
+        {
+            Vector<T> v(1002);
+            T* data = v.Data() + 1;
+            Simd::Fill(data, n, T(3), level);
+            assert(std::all_of(data, data + n, [](T x) { return x == T(3); }));
+            assert(v[0] == T(0) && data[n] == T(0));
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                data[i] = static_cast<T>(i % 100);
+            }
+            assert(Simd::Accumulate(data, n, T(1), level) == std::accumulate(data, data + n, T(1)));
+            assert(Simd::Find(data, n, T(100), level) == n);
+            for (size_t at : { size_t(0), n / 2, n - 1 })
+            {
+                if (n != 0 && n <= 100)
+                {
+                    assert(Simd::Find(data, n, static_cast<T>(at), level) == at);
+                }
+            }
+
+            Vector<T> out;
+            out.Resize(n);
+            Simd::Transform(data, n, out.Data(), [](auto x) { return x + x; }, level);
+            Simd::Transform(out.Data(), n, out.Data(), [](T x) { return static_cast<T>(x - 1); }, level);
+            Vector<double> wide;
+            wide.Resize(n);
+            Simd::CopyConvert(data, n, wide.Data(), level);
+            for (size_t i = 0; i < n; ++i)
+            {
+                assert(out[i] == static_cast<T>(data[i] + data[i] - 1));
+                assert(wide[i] == static_cast<double>(data[i]));
+            }
+        }
+    }
+}
+
+void Test30()
+{
+    TestSimdKernels<uint8_t>();
+    TestSimdKernels<int16_t>();
+    TestSimdKernels<int32_t>();
+    TestSimdKernels<int64_t>();
+    TestSimdKernels<float>();
+    TestSimdKernels<double>();
+    {
+        Vector<float> v;
+        v.Resize(1000);
+        Fill(v, 0.5f);
+        assert(Accumulate(v) == 500.0f);
+        assert(Accumulate(v, 1.0f) == 501.0f);
+        assert(Find(v, 1.0f) == v.end());
+        v[777] = 1.0f;
+        const Vector<float>& cv = v;
+        assert(Find(cv, 1.0f) - cv.begin() == 777);
+
+        Vector<float> doubled;
+        Transform(v, doubled, [](auto x) { return x * 2.0f; });
+        assert(doubled.Size() == 1000 && doubled[0] == 1.0f && doubled[777] == 2.0f);
+        Transform(doubled, doubled, [](auto x) { return x + 1.0f; });
+        assert(doubled[0] == 2.0f && doubled[777] == 3.0f);
+
+        Vector<int32_t> ints;
+        CopyConvert(doubled, ints);
+        assert(ints.Size() == 1000 && ints[0] == 2 && ints[777] == 3);
+        assert(Accumulate(ints) == 2 * 999 + 3);
+    }
+}
+
+void Test31()
+{
+    {
+        Vector<C> source(100);
+        C::Reset();
+        CowVector<C> table(std::move(source));
+        CowVector<C> copy = table;
+        CowVector<C> another;
+        another = copy;
+        // Копии разделяют буфер, элементы не копируются
+        assert(C::copy_ctor == 0 && C::move_ctor == 0);
+        assert(table.UseCount() == 3 && copy.IsShared());
+        assert(copy.Data() == table.Data() && another.Size() == 100);
+
+        // Первое изменение копирует элементы один раз, остальные копии не меняются
+        copy.Mutable().PushBack(C{});
+        assert(C::copy_ctor == 100);
+        assert(copy.Size() == 101 && table.Size() == 100 && another.Size() == 100);
+        assert(copy.Data() != table.Data() && !copy.IsShared() && table.UseCount() == 2);
+        copy.Mutable().PopBack();
+        assert(C::copy_ctor == 100);
+
+        // Единственный владелец меняет буфер на месте
+        another = CowVector<C>();
+        const C* data = table.Data();
+        table.Mutable().Resize(50);
+        assert(table.Data() == data && C::copy_ctor == 100 && table.UseCount() == 1);
+    }
+    assert(C::def_ctor + C::copy_ctor + C::move_ctor + 100 == C::dtor);
+    {
+        CowVector<int> empty;
+        assert(empty.Empty() && empty.UseCount() == 0 && empty.begin() == empty.end());
+        CowVector<int> copy = empty;
+        copy.Mutable().PushBack(1);
+        assert(empty.Empty() && copy.Size() == 1 && copy[0] == 1);
+        CowVector<int> moved = std::move(copy);
+        assert(copy.UseCount() == 0 && moved.UseCount() == 1 && moved[0] == 1);
+    }
+    {
+        // Читатели проверяют, что каждый снимок целиком состоит из одной версии
+        constexpr int VERSIONS = 200;
+        constexpr size_t SIZE = 1000;
+        CowVectorPublisher<int> publisher;
+        std::atomic<bool> done{ false };
+        std::vector<std::thread> readers;
+        std::atomic<size_t> loads{ 0 };
+        for (int reader = 0; reader < 4; ++reader)
+        {
+            readers.emplace_back([&] {
+                int last_version = -1;
+                while (!done.load(std::memory_order_acquire))
+                {
+                    const CowVector<int> snapshot = publisher.Load();
+                    if (snapshot.Empty())
+                    {
+                        continue;
+                    }
+                    const int version = snapshot[0];
+                    assert(version >= last_version);
+                    assert(snapshot.Size() == SIZE);
+                    assert(std::all_of(snapshot.begin(), snapshot.end(), [version](int x) { return x == version; }));
+                    last_version = version;
+                    loads.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+        for (int version = 0; version < VERSIONS; ++version)
+        {
+            Vector<int> next;
+            next.Resize(SIZE);
+            std::fill(next.begin(), next.end(), version);
+            publisher.Publish(CowVector<int>(std::move(next)));
+        }
+        // Дожидаемся хотя бы одного чтения, чтобы проверка не была пустой
+        while (loads.load(std::memory_order_relaxed) == 0)
+        {
+            std::this_thread::yield();
+        }
+        done.store(true, std::memory_order_release);
+        for (std::thread& reader : readers)
+        {
+            reader.join();
+        }
+        const CowVector<int> last = publisher.Load();
+        assert(last.UseCount() == 2 && last[SIZE - 1] == VERSIONS - 1);
+    }
+}
+
+void Test32()
+{
+    {
+        Vector<C> source(10);
+        Vector<C> target(3);
+        C::Reset();
+        // Вместимости не хватает: один новый буфер ровно под 10 элементов, без перемещений
+        target = source;
+        assert(target.Size() == 10 && target.Capacity() == 10);
+        assert(C::copy_ctor == 10 && C::move_ctor == 0 && C::copy_assign == 0 && C::dtor == 3);
+
+        // Вместимости хватает: буфер переиспользуется
+        const C* data = target.Data();
+        Vector<C> smaller(4);
+        C::Reset();
+        target = smaller;
+        assert(target.Data() == data && target.Size() == 4);
+        assert(C::copy_assign == 4 && C::dtor == 6 && C::copy_ctor == 0);
+        C::Reset();
+        target = source;
+        assert(target.Data() == data && C::copy_assign == 4 && C::copy_ctor == 6);
+    }
+    {
+        Vector<int> frame;
+        frame.Reserve(100);
+        const int* data = frame.Data();
+        Vector<int> next;
+        for (int i = 0; i < 100; ++i)
+        {
+            next.PushBack(i);
+        }
+        frame = next;
+        assert(frame.Data() == data && std::equal(frame.begin(), frame.end(), next.begin(), next.end()));
+        next.Resize(30);
+        frame = next;
+        assert(frame.Data() == data && frame.Size() == 30 && frame[29] == 29);
+
+        const std::array<int, 5> values = { 5, 4, 3, 2, 1 };
+        frame.Assign(values.begin(), values.end());
+        assert(frame.Data() == data && std::equal(frame.begin(), frame.end(), values.begin(), values.end()));
+        frame.Assign({ 7, 8 });
+        assert(frame.Size() == 2 && frame[0] == 7 && frame[1] == 8);
+        frame.Assign(150, 9);
+        assert(frame.Size() == 150 && frame.Capacity() == 150 && frame[149] == 9);
+
+        std::istringstream input("1 2 3");
+        frame.Assign(std::istream_iterator<int>(input), std::istream_iterator<int>());
+        assert(frame.Size() == 3 && frame[2] == 3);
+    }
+    {
+        // Недостающая вместимость добавляется на месте, как в Reserve, без второго буфера
+        MonotonicArena arena(1024 * sizeof(int));
+        Vector<int, ArenaAllocator<int>> v{ ArenaAllocator<int>(arena) };
+        v.Reserve(2);
+        const int* data = v.Data();
+        const size_t reserved = arena.BytesReserved();
+        std::vector<int> source(100);
+        std::iota(source.begin(), source.end(), 0);
+        v.Assign(source.begin(), source.end());
+        assert(v.Data() == data && v.Size() == 100 && v[99] == 99);
+        v.Assign(200, v[5]);
+        assert(v.Data() == data && v.Size() == 200 && v[199] == 5);
+        assert(arena.BytesReserved() == reserved);
+
+        // Reallocate переносит буфер, поэтому значение-элемент копируется заранее
+        Vector<int, MallocAllocator<int>> m;
+        m.Append({ 7, 8 });
+        m.Assign(10000, m[1]);
+        assert(m.Size() == 10000 && m[0] == 8 && m[9999] == 8);
+        const Vector<int, MallocAllocator<int>> big(20000);
+        m = big;
+        assert(m.Size() == 20000 && m[19999] == 0);
+    }
+    {
+        // Значение может быть элементом самого вектора
+        Vector<std::string> words;
+        words.PushBack("a");
+        words.PushBack(std::string(40, 'x'));
+        words.Assign(1, words[1]);
+        assert(words.Size() == 1 && words[0] == std::string(40, 'x'));
+        words.Assign(5, words[0]);
+        assert(words.Size() == 5 && words[4] == std::string(40, 'x'));
+        const std::vector<std::string> source = { "b", "c" };
+        words.Assign(source.begin(), source.end());
+        assert(words.Size() == 2 && words[0] == "b" && words[1] == "c");
+    }
+    {
+        // Источник — указатели на элементы другого, приводимого к T типа
+        int ints[] = { 1, 2, 3 };
+        Vector<long> longs;
+        longs.Assign(ints, ints + 3);
+        assert(longs.Size() == 3 && longs[2] == 3L);
+        longs.Assign(ints, ints + 2);
+        assert(longs.Size() == 2 && longs[1] == 2L);
+
+        const char* names[] = { "x", "y" };
+        Vector<std::string> strings;
+        strings.Assign(names, names + 2);
+        assert(strings.Size() == 2 && strings[1] == "y");
+        strings.Assign(names, names + 1);
+        assert(strings.Size() == 1 && strings[0] == "x");
+    }
+#if defined(VECTOR_ENABLE_STATS)
+    {
+        struct Pixel
+        {
+            float r, g, b;
+        };
+        Vector<Pixel> frame;
+        Vector<Pixel> next(1000);
+        ResetVectorStats();
+        frame = next;
+        next.Resize(500);
+        frame = next;
+        frame.Assign(next.begin(), next.end());
+        // Одна реаллокация на первом присваивании, дальше буфер переиспользуется
+        assert(GetVectorStats<Pixel>().allocations == 1);
+    }
+#endif
+}
+
+void Test33()
+{
+    {
+        Vector<double> plain;
+        plain.Reserve(10);
+        assert(plain.MemoryUsage() == 10 * sizeof(double));
+        assert(plain.TryReserve(20) && plain.Capacity() == 20);
+        assert(!plain.TryReserve(static_cast<size_t>(-1) / 2));
+        assert(plain.Capacity() == 20);
+    }
+    {
+        using Alloc = AccountingAllocator<int>;
+        VectorMemoryAccount tenant(1000);
+        {
+            Vector<int, Alloc> a{ Alloc(tenant) };
+            Vector<int, Alloc> b{ Alloc(tenant) };
+            a.Reserve(100);
+            b.Reserve(50);
+            assert(tenant.LiveBytes() == a.MemoryUsage() + b.MemoryUsage());
+            assert(tenant.LiveBytes() == 600);
+
+            // Бюджет исчерпан: рост отказывает сразу, вектор не меняется
+            assert(!a.TryReserve(200));
+            assert(a.Capacity() == 100);
+            assert(b.TryReserve(100) && tenant.LiveBytes() == 800);
+            for (int i = 0; i < 100; ++i)
+            {
+                a.PushBack(i);
+            }
+            bool thrown = false;
+            try
+            {
+                a.PushBack(100);
+            }
+            catch (const VectorBudgetExceeded&)
+            {
+                thrown = true;
+            }
+            assert(thrown && a.Size() == 100 && a[99] == 99 && a.Capacity() == 100);
+
+            // После увеличения лимита рост снова возможен
+            tenant.SetLimit(2000);
+            a.PushBack(100);
+            assert(a.Capacity() == 200 && tenant.LiveBytes() == 1200);
+            assert(tenant.PeakBytes() == 1600);
+
+            Vector<int, Alloc> copy = a;
+            assert(copy.GetAllocator() == a.GetAllocator());
+            assert(tenant.LiveBytes() == 1200 + copy.MemoryUsage());
+        }
+        assert(tenant.LiveBytes() == 0);
     }
-    try
     {
-        const size_t NUM = 10;
-        C c;
+        // reallocate аллокатора Base учитывается разницей размеров
+        using Alloc = AccountingAllocator<int, MallocAllocator<int>>;
+        VectorMemoryAccount tenant(64 * sizeof(int));
+        Vector<int, Alloc> v{ Alloc(tenant) };
+        for (int i = 0; i < 64; ++i)
         {
-            cerr << "Vector:"sv << endl;
-            C::Reset();
-            Vector<C> v(NUM);
-            Dump();
-            v.PushBack(c);
+            v.PushBack(i);
         }
-        Dump();
+        assert(tenant.LiveBytes() == 64 * sizeof(int));
+        assert(!v.TryReserve(65) && v.Capacity() == 64 && v[63] == 63);
     }
-    catch (...)
     {
+        // Расширение на месте в пуле списывает только прирост
+        PoolResource pool;
+        using Alloc = AccountingAllocator<int, PoolAllocator<int>>;
+        VectorMemoryAccount tenant;
+        Vector<int, Alloc> v{ Alloc(tenant, PoolAllocator<int>(pool)) };
+        v.Reserve(3);
+        const int* data = v.Data();
+        v.Reserve(4);
+        assert(v.Data() == data && tenant.LiveBytes() == 4 * sizeof(int));
     }
 }
 
@@ -703,7 +2684,32 @@ int main()
         Test4();
         Test5();
         Test6();
-        Benchmark();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
+        Test30();
+        Test31();
+        Test32();
+        Test33();
     }
     catch (const std::exception& e)
     {
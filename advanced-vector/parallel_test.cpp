@@ -0,0 +1,122 @@
+// Тесты параллельного копирования и переноса (vector_parallel.h).
+// Собираются отдельно от main.cpp, потому что элементы здесь создаются в нескольких
+// потоках, а счётчики объектов main.cpp не атомарны. Небольшой порог и фиксированное
+// число потоков включают параллельный путь и на одноядерной машине
+#if !defined(VECTOR_ENABLE_PARALLEL)
+#define VECTOR_ENABLE_PARALLEL
+#endif
+#if !defined(VECTOR_PARALLEL_THRESHOLD)
+#define VECTOR_PARALLEL_THRESHOLD (size_t{ 64 })
+#endif
+#if !defined(VECTOR_PARALLEL_THREADS)
+#define VECTOR_PARALLEL_THREADS 4
+#endif
+
+#include "vector.h"
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace
+{
+
+const std::thread::id main_thread_id = std::this_thread::get_id();
+
+// Счётчики атомарны: элементы создаются в нескольких потоках
+struct AtomicCounted
+{
+    explicit AtomicCounted(int value)
+        : value(value)
+    {
+        ++alive;
+    }
+    AtomicCounted(const AtomicCounted& other)
+        : value(other.value)
+    {
+        if (other.throw_on_copy)
+        {
+            throw std::runtime_error("Oops");
+        }
+        ++alive;
+        if (std::this_thread::get_id() != main_thread_id)
+        {
+            ++copied_on_workers;
+        }
+    }
+    AtomicCounted(AtomicCounted&& other) noexcept
+        : value(other.value)
+    {
+        ++alive;
+    }
+    AtomicCounted& operator=(const AtomicCounted&) = default;
+    ~AtomicCounted()
+    {
+        --alive;
+    }
+
+    int value = 0;
+    bool throw_on_copy = false;
+    std::string payload = "payload";
+    static inline std::atomic<int> alive{ 0 };
+    static inline std::atomic<int> copied_on_workers{ 0 };
+};
+
+void TestParallelCopy()
+{
+    const size_t SIZE = VECTOR_PARALLEL_THRESHOLD * 8;
+    {
+        Vector<AtomicCounted> v;
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        Vector<AtomicCounted> copy(v);
+        assert(copy.Size() == SIZE);
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            assert(copy[i].value == static_cast<int>(i));
+        }
+        assert(AtomicCounted::alive == static_cast<int>(2 * SIZE));
+        // Часть элементов создана рабочими потоками
+        assert(AtomicCounted::copied_on_workers > 0);
+
+        // Исключение в одной из частей: созданные копии удаляются, приёмник не меняется
+        v[SIZE - 1].throw_on_copy = true;
+        Vector<AtomicCounted> target;
+        target.EmplaceBack(-1);
+        try
+        {
+            target = v;
+            assert(false);
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+        assert(target.Size() == 1 && target[0].value == -1);
+        assert(AtomicCounted::alive == static_cast<int>(2 * SIZE + 1));
+
+        copy.Reserve(SIZE * 2);
+        assert(copy[SIZE - 1].value == static_cast<int>(SIZE - 1));
+        assert(AtomicCounted::alive == static_cast<int>(2 * SIZE + 1));
+    }
+    assert(AtomicCounted::alive == 0);
+}
+
+}  // namespace
+
+int main()
+{
+    try
+    {
+        TestParallelCopy();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
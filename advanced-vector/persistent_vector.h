@@ -0,0 +1,423 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+PersistentVector<T> — Vector, элементы которого хранятся в файле, отображённом
+в память (mmap). После перезапуска сервис открывает файл и сразу работает
+с данными, не десериализуя их. Доступен только для тривиально копируемых T
+и только на POSIX-системах.
+
+Как и в SmallVector, весь код Vector используется без изменений, а хранением
+управляет аллокатор: MappedFileAllocator выдаёт в качестве буфера область файла
+за заголовком, а при росте увеличивает файл (ftruncate) и переотображает его
+(mremap в Linux, новое отображение того же файла на других системах), так что
+элементы не копируются. Файл хранит один буфер, поэтому операции, которым нужен
+второй буфер, завершаются std::bad_alloc. Рост через Reserve, вставку и Assign
+расширяет этот буфер на месте. ShrinkToFit не предоставляется: уменьшить буфер
+без второго буфера нельзя.
+
+Формат файла: заголовок размером HEADER_SIZE байт (сигнатура, версия формата,
+размер элемента и количество элементов), за которым следуют элементы.
+Количество элементов записывается в заголовок вызовом Flush(), который также
+сбрасывает отображение на диск (msync). Close() и деструктор вызывают Flush().
+*/
+class MappedFileStorage
+{
+public:
+    static constexpr size_t HEADER_SIZE = 4096;
+    static constexpr uint64_t MAGIC = 0x3152544345564156;  // "VAVECTR1"
+    static constexpr uint32_t VERSION = 1;
+
+    MappedFileStorage() = default;
+
+    MappedFileStorage(const MappedFileStorage&) = delete;
+    MappedFileStorage& operator=(const MappedFileStorage&) = delete;
+
+    ~MappedFileStorage()
+    {
+        Close();
+    }
+
+    // Открывает или создаёт файл с элементами размером element_size байт.
+    // Бросает std::system_error при ошибке ввода-вывода и std::runtime_error,
+    // если файл создан для элементов другого размера или повреждён
+    void Open(const char* path, size_t element_size)
+    {
+        assert(!IsOpen());
+        const int fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "open");
+        }
+        try
+        {
+            MapFile(fd, element_size);
+        }
+        catch (...)
+        {
+            ::close(fd);
+            throw;
+        }
+    }
+
+    bool IsOpen() const noexcept
+    {
+        return base_ != nullptr;
+    }
+
+    // Адрес области данных за заголовком
+    void* Address() const noexcept
+    {
+        return base_ != nullptr ? base_ + HEADER_SIZE : nullptr;
+    }
+
+    size_t DataBytes() const noexcept
+    {
+        return base_ != nullptr ? mapped_bytes_ - HEADER_SIZE : 0;
+    }
+
+    // Количество элементов, записанное последним вызовом Flush
+    size_t StoredSize() const noexcept
+    {
+        return base_ != nullptr ? static_cast<size_t>(GetHeader().size) : 0;
+    }
+
+    // Записывает количество элементов в заголовок и сбрасывает отображение на диск
+    void Flush(size_t size)
+    {
+        assert(IsOpen());
+        GetHeader().size = size;
+        if (msync(base_, mapped_bytes_, MS_SYNC) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "msync");
+        }
+    }
+
+    void Close() noexcept
+    {
+        if (base_ != nullptr)
+        {
+            munmap(base_, mapped_bytes_);
+            ::close(fd_);
+            base_ = nullptr;
+            mapped_bytes_ = 0;
+            fd_ = -1;
+            buffer_in_use_ = false;
+        }
+    }
+
+    // Отдаёт область данных единственному буферу, при необходимости увеличив её до bytes
+    bool AcquireBuffer(size_t bytes) noexcept
+    {
+        if (!IsOpen() || buffer_in_use_ || (bytes > DataBytes() && !Grow(bytes, true)))
+        {
+            return false;
+        }
+        buffer_in_use_ = true;
+        return true;
+    }
+
+    void ReleaseBuffer() noexcept
+    {
+        buffer_in_use_ = false;
+    }
+
+    // Увеличивает файл и отображение до HEADER_SIZE + data_bytes байт. Если may_move
+    // ложно, отображение расширяется только на месте. При неудаче ничего не меняется
+    bool Grow(size_t data_bytes, bool may_move) noexcept
+    {
+        assert(IsOpen());
+        if (data_bytes <= DataBytes())
+        {
+            return true;
+        }
+        if (data_bytes > static_cast<size_t>(INT64_MAX) - HEADER_SIZE)
+        {
+            return false;
+        }
+        const size_t new_bytes = HEADER_SIZE + data_bytes;
+        if (ftruncate(fd_, static_cast<off_t>(new_bytes)) != 0)
+        {
+            return false;
+        }
+#if defined(__linux__)
+        void* result = mremap(base_, mapped_bytes_, new_bytes, may_move ? MREMAP_MAYMOVE : 0);
+#else
+        // Второе отображение того же файла видит те же страницы, поэтому данные не копируются
+        void* result = may_move ? mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0) : MAP_FAILED;
+        if (result != MAP_FAILED)
+        {
+            munmap(base_, mapped_bytes_);
+        }
+#endif
+        if (result == MAP_FAILED)
+        {
+            [[maybe_unused]] const int restored = ftruncate(fd_, static_cast<off_t>(mapped_bytes_));
+            return false;
+        }
+        base_ = static_cast<char*>(result);
+        mapped_bytes_ = new_bytes;
+        return true;
+    }
+
+private:
+    struct Header
+    {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t element_size;
+        uint64_t size;
+    };
+
+    Header& GetHeader() const noexcept
+    {
+        return *reinterpret_cast<Header*>(base_);
+    }
+
+    void MapFile(int fd, size_t element_size)
+    {
+        struct stat info
+        {};
+        if (fstat(fd, &info) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "fstat");
+        }
+        size_t file_bytes = static_cast<size_t>(info.st_size);
+        const bool is_new = file_bytes == 0;
+        if (is_new)
+        {
+            file_bytes = HEADER_SIZE;
+            if (ftruncate(fd, static_cast<off_t>(file_bytes)) != 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "ftruncate");
+            }
+        }
+        if (file_bytes < HEADER_SIZE || (file_bytes - HEADER_SIZE) % element_size != 0)
+        {
+            throw std::runtime_error("MappedFileStorage: unexpected file size");
+        }
+
+        void* mapped = mmap(nullptr, file_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED)
+        {
+            throw std::system_error(errno, std::generic_category(), "mmap");
+        }
+        base_ = static_cast<char*>(mapped);
+        mapped_bytes_ = file_bytes;
+        fd_ = fd;
+
+        Header& header = GetHeader();
+        if (is_new)
+        {
+            header = Header{ MAGIC, VERSION, static_cast<uint32_t>(element_size), 0 };
+            return;
+        }
+        if (header.magic != MAGIC || header.version != VERSION || header.element_size != element_size
+            || header.size > DataBytes() / element_size)
+        {
+            munmap(base_, mapped_bytes_);
+            base_ = nullptr;
+            mapped_bytes_ = 0;
+            fd_ = -1;
+            throw std::runtime_error("MappedFileStorage: incompatible file header");
+        }
+    }
+
+    int fd_ = -1;
+    char* base_ = nullptr;
+    size_t mapped_bytes_ = 0;
+    bool buffer_in_use_ = false;
+};
+
+template <typename T>
+class MappedFileAllocator
+{
+    static_assert(std::is_trivially_copyable_v<T>, "MappedFileAllocator requires trivially copyable T");
+
+public:
+    using value_type = T;
+
+    // Область данных начинается с границы страницы
+    static constexpr size_t alignment = MappedFileStorage::HEADER_SIZE;
+
+    explicit MappedFileAllocator(MappedFileStorage& storage) noexcept
+        : storage_(&storage)
+    {}
+
+    T* allocate(size_t n)
+    {
+        if (n > static_cast<size_t>(-1) / sizeof(T) || !storage_->AcquireBuffer(n * sizeof(T)))
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(storage_->Address());
+    }
+
+    // Данные остаются в файле, освобождается только право на буфер
+    void deallocate(T* /*ptr*/, size_t /*n*/) noexcept
+    {
+        storage_->ReleaseBuffer();
+    }
+
+    bool try_expand(T* /*ptr*/, size_t /*old_n*/, size_t new_n) noexcept
+    {
+        return new_n <= static_cast<size_t>(-1) / sizeof(T) && storage_->Grow(new_n * sizeof(T), false);
+    }
+
+    T* reallocate(T* /*ptr*/, size_t /*old_n*/, size_t new_n)
+    {
+        if (new_n > static_cast<size_t>(-1) / sizeof(T) || !storage_->Grow(new_n * sizeof(T), true))
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(storage_->Address());
+    }
+
+    bool operator==(const MappedFileAllocator& other) const noexcept
+    {
+        return storage_ == other.storage_;
+    }
+
+    bool operator!=(const MappedFileAllocator& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+    MappedFileStorage* storage_;
+};
+
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+class PersistentVector
+    : private MappedFileStorage  // хранилище создаётся раньше Vector и разрушается позже
+    , private Vector<T, MappedFileAllocator<T>, GrowthPolicy>
+{
+    using Storage = MappedFileStorage;
+    using Base = Vector<T, MappedFileAllocator<T>, GrowthPolicy>;
+
+public:
+    using typename Base::iterator;
+    using typename Base::const_iterator;
+    using typename Base::allocator_type;
+    using typename Base::growth_policy;
+    using typename Base::BackInserter;
+
+    /*
+    Vector наследуется закрыто, как в SmallVector: через ссылку Vector& буфер,
+    указывающий в отображение файла, можно было бы переместить, обменять или
+    забрать через Release, и он пережил бы Close. Поэтому наружу открыты только
+    операции, не передающие буфер другому владельцу.
+    */
+    using Base::begin;
+    using Base::end;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::Resize;
+    using Base::ResizeDefaultInit;
+    using Base::ResizeAndOverwrite;
+    using Base::EmplaceBack;
+    using Base::PushBack;
+    using Base::EmplaceBackUnchecked;
+    using Base::PopBack;
+    using Base::Emplace;
+    using Base::Insert;
+    using Base::Append;
+    using Base::Assign;
+    using Base::Erase;
+    using Base::Size;
+    using Base::Capacity;
+    using Base::Data;
+#if defined(__cpp_lib_span)
+    using Base::AsSpan;
+    using Base::AsBytes;
+    using Base::AsWritableBytes;
+#endif
+    using Base::operator[];
+    using Base::GetAllocator;
+    using Base::Reserve;
+    using Base::TryReserve;
+    using Base::MemoryUsage;
+    using Base::ReserveBack;
+
+    PersistentVector()
+        : Base(allocator_type(static_cast<Storage&>(*this)))
+    {}
+
+    explicit PersistentVector(const std::string& path)
+        : PersistentVector()
+    {
+        Open(path);
+    }
+
+    // Аллокатор ссылается на хранилище внутри объекта, поэтому объект нельзя копировать и перемещать
+    PersistentVector(const PersistentVector&) = delete;
+    PersistentVector& operator=(const PersistentVector&) = delete;
+    void Swap(PersistentVector&) = delete;
+
+    ~PersistentVector()
+    {
+        try
+        {
+            Close();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    // Закрывает текущий файл и отображает файл path. Элементы, сохранённые
+    // в файле последним Flush, сразу доступны без копирования
+    void Open(const std::string& path)
+    {
+        Close();
+        Storage::Open(path.c_str(), sizeof(T));
+        const size_t capacity = Storage::DataBytes() / sizeof(T);
+        if (capacity != 0)
+        {
+            [[maybe_unused]] const bool acquired = Storage::AcquireBuffer(capacity * sizeof(T));
+            assert(acquired);
+            Base::Adopt(static_cast<T*>(Storage::Address()), Storage::StoredSize(), capacity);
+        }
+    }
+
+    bool IsOpen() const noexcept
+    {
+        return Storage::IsOpen();
+    }
+
+    // Сохраняет количество элементов в заголовке файла и сбрасывает данные на диск
+    void Flush()
+    {
+        Storage::Flush(Base::Size());
+    }
+
+    // Сохраняет элементы и закрывает файл. Вектор становится пустым
+    void Close()
+    {
+        if (!Storage::IsOpen())
+        {
+            return;
+        }
+        Flush();
+        // Буфер принадлежит отображению файла: забираем его у Vector, не освобождая
+        static_cast<void>(Base::Release());
+        Storage::Close();
+    }
+};
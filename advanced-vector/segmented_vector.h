@@ -0,0 +1,385 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <type_traits>
+
+/*
+SegmentedVector<T> хранит элементы в блоках (сегментах) фиксированного размера
+SEGMENT_SIZE, каждый из которых — отдельный буфер RawMemory<T, Alloc>.
+
+При росте добавляется новый сегмент, а уже созданные элементы никогда не
+перемещаются: указатели и ссылки на них остаются действительными до удаления
+самого элемента, а стоимость роста не зависит от размера контейнера.
+Перевыделяется только таблица сегментов — Vector из RawMemory, элементы которого
+(указатель и вместимость) перемещаются за O(1).
+
+SEGMENT_SIZE — степень двойки, поэтому доступ по индексу сводится к сдвигу и маске.
+По умолчанию сегмент занимает около 4 КиБ.
+*/
+
+// Наибольшая степень двойки, при которой сегмент из элементов T не превышает 4 КиБ
+template <typename T>
+constexpr size_t DefaultSegmentSize() noexcept
+{
+    size_t result = 1;
+    while (result * 2 * sizeof(T) <= 4096)
+    {
+        result *= 2;
+    }
+    return result;
+}
+
+template <typename T, size_t SEGMENT_SIZE = DefaultSegmentSize<T>(), typename Alloc = std::allocator<T>>
+class SegmentedVector
+{
+    static_assert(SEGMENT_SIZE != 0 && (SEGMENT_SIZE & (SEGMENT_SIZE - 1)) == 0,
+                  "SEGMENT_SIZE must be a power of two");
+
+    template <bool IS_CONST>
+    class BasicIterator;
+
+public:
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+    using allocator_type = Alloc;
+
+    SegmentedVector() = default;
+
+    explicit SegmentedVector(const Alloc& alloc)
+        : alloc_(alloc)
+    {}
+
+    // Конструктор делегирует создание пустого объекта, поэтому при исключении
+    // деструктор удалит уже скопированные элементы
+    SegmentedVector(const SegmentedVector& other)
+        : SegmentedVector(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.alloc_))
+    {
+        Reserve(other.size_);
+        for (const T& value : other)
+        {
+            EmplaceBack(value);
+        }
+    }
+
+    SegmentedVector(SegmentedVector&& other) noexcept
+        : alloc_(other.alloc_)
+        , segments_(std::move(other.segments_))
+        , size_(std::exchange(other.size_, 0))
+    {}
+
+    ~SegmentedVector()
+    {
+        while (size_ > 0)
+        {
+            PopBack();
+        }
+    }
+
+    SegmentedVector& operator=(const SegmentedVector& rhs)
+    {
+        if (this != &rhs)
+        {
+            SegmentedVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SegmentedVector& operator=(SegmentedVector&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    void Swap(SegmentedVector& other) noexcept
+    {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        segments_.Swap(other.segments_);
+        std::swap(size_, other.size_);
+    }
+
+    // Элементы создаются в последнем сегменте; если он заполнен, выделяется новый.
+    // Если конструктор элемента выбросит исключение, контейнер не изменится
+    // (выделенный сегмент остаётся в запасе). Сложность — амортизированная константа
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args)
+    {
+        if (size_ == Capacity())
+        {
+            AddSegment();
+        }
+        T* slot = SlotAt(size_);
+        new(slot) T(std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    void PushBack(const T& value)
+    {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value)
+    {
+        EmplaceBack(std::move(value));
+    }
+
+    // При вызове у пустого контейнера поведение не определено. Сегменты не освобождаются
+    void PopBack() noexcept
+    {
+        assert(size_ > 0);
+        --size_;
+        std::destroy_at(SlotAt(size_));
+    }
+
+    // Выделяет сегменты так, чтобы вместить new_capacity элементов
+    void Reserve(size_t new_capacity)
+    {
+        if (new_capacity <= Capacity())
+        {
+            return;
+        }
+        segments_.Reserve((new_capacity + SEGMENT_SIZE - 1) / SEGMENT_SIZE);
+        while (Capacity() < new_capacity)
+        {
+            AddSegment();
+        }
+    }
+
+    const T& operator[](size_t index) const noexcept
+    {
+        return const_cast<SegmentedVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept
+    {
+        assert(index < size_);
+        return *SlotAt(index);
+    }
+
+    size_t Size() const noexcept
+    {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept
+    {
+        return segments_.Size() * SEGMENT_SIZE;
+    }
+
+    static constexpr size_t SegmentSize() noexcept
+    {
+        return SEGMENT_SIZE;
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator(this, 0);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(this, size_);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, size_);
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    Alloc GetAllocator() const noexcept
+    {
+        return alloc_;
+    }
+
+private:
+    static constexpr size_t SEGMENT_SHIFT = [] {
+        size_t shift = 0;
+        while ((size_t{ 1 } << shift) < SEGMENT_SIZE)
+        {
+            ++shift;
+        }
+        return shift;
+    }();
+
+    void AddSegment()
+    {
+        segments_.EmplaceBack(SEGMENT_SIZE, alloc_);
+    }
+
+    T* SlotAt(size_t index) noexcept
+    {
+        return segments_[index >> SEGMENT_SHIFT] + (index & (SEGMENT_SIZE - 1));
+    }
+
+    /*
+    Итератор произвольного доступа хранит контейнер и индекс элемента.
+    В отличие от указателя, он не становится недействительным при добавлении элементов.
+    */
+    template <bool IS_CONST>
+    class BasicIterator
+    {
+        using Container = std::conditional_t<IS_CONST, const SegmentedVector, SegmentedVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IS_CONST, const T*, T*>;
+        using reference = std::conditional_t<IS_CONST, const T&, T&>;
+
+        BasicIterator() = default;
+
+        BasicIterator(Container* container, size_t index) noexcept
+            : container_(container)
+            , index_(index)
+        {}
+
+        // Неконстантный итератор неявно преобразуется в константный
+        template <bool OTHER_IS_CONST, typename = std::enable_if_t<IS_CONST && !OTHER_IS_CONST>>
+        BasicIterator(const BasicIterator<OTHER_IS_CONST>& other) noexcept
+            : container_(other.container_)
+            , index_(other.index_)
+        {}
+
+        reference operator*() const noexcept
+        {
+            return (*container_)[index_];
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &**this;
+        }
+
+        reference operator[](difference_type offset) const noexcept
+        {
+            return *(*this + offset);
+        }
+
+        BasicIterator& operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept
+        {
+            BasicIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        BasicIterator& operator--() noexcept
+        {
+            --index_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept
+        {
+            BasicIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept
+        {
+            index_ += offset;
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type offset) noexcept
+        {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept
+        {
+            return it += offset;
+        }
+
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept
+        {
+            return it += offset;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept
+        {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept
+        {
+            assert(lhs.container_ == rhs.container_);
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept
+        {
+            return lhs.container_ == rhs.container_ && lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept
+        {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept
+        {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept
+        {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept
+        {
+            return !(lhs < rhs);
+        }
+
+    private:
+        friend class BasicIterator<!IS_CONST>;
+
+        Container* container_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    Alloc alloc_;
+    // Таблица сегментов. RawMemory перемещается за O(1), элементы при этом остаются на месте
+    Vector<RawMemory<T, Alloc>> segments_;
+    size_t size_ = 0;
+};
@@ -0,0 +1,299 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <type_traits>
+
+/*
+SmallVector<T, N> хранит до N элементов прямо в объекте и обращается к куче,
+только когда элементов становится больше.
+
+SmallVector — это Vector с особым аллокатором SmallBufferAllocator, который
+выдаёт встроенный буфер на любой запрос не больше N элементов, пока буфер
+свободен, а остальные запросы передаёт аллокатору Upstream. Поэтому весь код
+Vector (рост, Emplace, Erase, гарантии безопасности исключений) используется
+без изменений: переход во встроенный буфер и обратно — обычная реаллокация.
+
+Встроенный буфер не может сменить владельца, поэтому копирование SmallVector
+и перемещение из встроенного буфера выполняются поэлементно. Буфер в куче
+перемещается без копирования элементов, как в Vector.
+*/
+
+// Встроенный буфер на N элементов вместе с признаком занятости
+template <typename T, size_t N>
+struct SmallBufferStorage
+{
+    bool Contains(const T* ptr) const noexcept
+    {
+        return ptr == reinterpret_cast<const T*>(buffer);
+    }
+
+    alignas(T) unsigned char buffer[N * sizeof(T)];
+    bool in_use = false;
+};
+
+template <typename T, size_t N, typename Upstream = std::allocator<T>>
+class SmallBufferAllocator
+{
+public:
+    using value_type = T;
+
+    explicit SmallBufferAllocator(SmallBufferStorage<T, N>& storage, const Upstream& upstream = Upstream()) noexcept
+        : storage_(&storage)
+        , upstream_(upstream)
+    {}
+
+    T* allocate(size_t n)
+    {
+        if (n <= N && !storage_->in_use)
+        {
+            storage_->in_use = true;
+            return reinterpret_cast<T*>(storage_->buffer);
+        }
+        return std::allocator_traits<Upstream>::allocate(upstream_, n);
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept
+    {
+        if (storage_->Contains(ptr))
+        {
+            storage_->in_use = false;
+            return;
+        }
+        std::allocator_traits<Upstream>::deallocate(upstream_, ptr, n);
+    }
+
+    // Встроенный буфер расширяется "на месте" до N элементов
+    bool try_expand(T* ptr, size_t /*old_n*/, size_t new_n) noexcept
+    {
+        return storage_->Contains(ptr) && new_n <= N;
+    }
+
+    const Upstream& GetUpstream() const noexcept
+    {
+        return upstream_;
+    }
+
+    bool operator==(const SmallBufferAllocator& other) const noexcept
+    {
+        return storage_ == other.storage_;
+    }
+
+    bool operator!=(const SmallBufferAllocator& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+    SmallBufferStorage<T, N>* storage_;
+    Upstream upstream_;
+};
+
+/*
+Политика роста SmallVector: растёт как GrowthPolicy, а уменьшение (если GrowthPolicy
+его предусматривает, см. ShrinkingGrowth) никогда не опускает вместимость ниже N.
+Встроенный буфер не уменьшается, а буфер в куче возвращается во встроенный, как только
+элементов остаётся не больше половины встроенного буфера. Запрос на N элементов
+при свободном встроенном буфере выделяет именно его.
+*/
+template <typename GrowthPolicy, size_t N>
+struct SmallBufferGrowth : GrowthPolicy
+{
+    template <typename T, typename Alloc, typename Policy = GrowthPolicy>
+    static constexpr auto ShrinkCapacity(size_t capacity, size_t size) noexcept
+        -> decltype(Policy::template ShrinkCapacity<T, Alloc>(capacity, size))
+    {
+        if (capacity <= N)
+        {
+            return capacity;
+        }
+        if (size <= N / 2)
+        {
+            return N;
+        }
+        return std::max(Policy::template ShrinkCapacity<T, Alloc>(capacity, size), N);
+    }
+};
+
+template <typename T, size_t N, typename Upstream = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class SmallVector
+    : private SmallBufferStorage<T, N>  // базовый класс-хранилище создаётся раньше Vector и разрушается позже
+    , private Vector<T, SmallBufferAllocator<T, N, Upstream>, SmallBufferGrowth<GrowthPolicy, N>>
+{
+    static_assert(N > 0, "SmallVector requires a non-empty inline buffer");
+
+    using Storage = SmallBufferStorage<T, N>;
+    using Base = Vector<T, SmallBufferAllocator<T, N, Upstream>, SmallBufferGrowth<GrowthPolicy, N>>;
+
+public:
+    using typename Base::iterator;
+    using typename Base::const_iterator;
+    using typename Base::allocator_type;
+    using growth_policy = GrowthPolicy;
+    using typename Base::BackInserter;
+
+    static constexpr size_t INLINE_CAPACITY = N;
+
+    /*
+    Vector наследуется закрыто: ссылка Vector& на SmallVector позволила бы
+    переместить, обменять или забрать через Release буфер, указывающий внутрь
+    объекта. Поэтому наружу открыты только операции, не передающие буфер
+    другому владельцу.
+    */
+    using Base::begin;
+    using Base::end;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::Resize;
+    using Base::ResizeDefaultInit;
+    using Base::ResizeAndOverwrite;
+    using Base::EmplaceBack;
+    using Base::PushBack;
+    using Base::EmplaceBackUnchecked;
+    using Base::PopBack;
+    using Base::Emplace;
+    using Base::Insert;
+    using Base::Append;
+    using Base::Assign;
+    using Base::Erase;
+    using Base::Size;
+    using Base::Capacity;
+    using Base::Data;
+#if defined(__cpp_lib_span)
+    using Base::AsSpan;
+    using Base::AsBytes;
+    using Base::AsWritableBytes;
+#endif
+    using Base::operator[];
+    using Base::GetAllocator;
+    using Base::Reserve;
+    using Base::TryReserve;
+    using Base::MemoryUsage;
+    using Base::ReserveBack;
+
+    SmallVector()
+        : Base(MakeAllocator())
+    {
+        Base::Reserve(N);
+    }
+
+    explicit SmallVector(size_t size)
+        : SmallVector()
+    {
+        Base::Resize(size);
+    }
+
+    SmallVector(const SmallVector& other)
+        : Base(other, MakeAllocator())
+    {
+        Base::Reserve(N);
+    }
+
+    // Буфер в куче переходит к новому SmallVector, а other возвращается во встроенный буфер
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : Base(MakeAllocator(other.GetAllocator().GetUpstream()))
+    {
+        if (other.IsInline())
+        {
+            // Вместимости N хватает, и память не выделяется
+            Base::Reserve(N);
+            Base::operator=(std::move(other));
+        }
+        else
+        {
+            StealHeapBuffer(other);
+        }
+    }
+
+    SmallVector& operator=(const SmallVector& rhs)
+    {
+        Base::operator=(rhs);
+        return *this;
+    }
+
+    // Вместимость SmallVector не меньше N, поэтому перемещение из встроенного буфера не выделяет память
+    SmallVector& operator=(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>
+                                                        && std::is_nothrow_move_assignable_v<T>)
+    {
+        if (this == &rhs)
+        {
+            return *this;
+        }
+        if (!rhs.IsInline()
+            && (std::allocator_traits<Upstream>::is_always_equal::value
+                || Base::GetAllocator().GetUpstream() == rhs.GetAllocator().GetUpstream()))
+        {
+            StealHeapBuffer(rhs);
+        }
+        else
+        {
+            // Аллокаторы разных SmallVector не равны, и Vector перемещает элементы поштучно
+            Base::operator=(std::move(rhs));
+        }
+        return *this;
+    }
+
+    void Swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>
+                                           && std::is_nothrow_move_assignable_v<T>)
+    {
+        SmallVector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    // Уменьшает вместимость до max(Size(), N). Элементы из кучи, которые помещаются
+    // во встроенный буфер, переносятся в него; встроенный буфер не меняется
+    void ShrinkToFit()
+    {
+        const size_t new_capacity = std::max(Base::Size(), N);
+        if (!IsInline() && new_capacity < Base::Capacity())
+        {
+            Base::ShrinkTo(new_capacity);
+        }
+    }
+
+    // Находятся ли элементы во встроенном буфере
+    bool IsInline() const noexcept
+    {
+        return Storage::Contains(Base::begin());
+    }
+
+private:
+    allocator_type MakeAllocator(const Upstream& upstream = Upstream()) noexcept
+    {
+        return allocator_type(static_cast<Storage&>(*this), upstream);
+    }
+
+    // Забирает буфер other из кучи. Он выделен аллокатором Upstream, равным нашему,
+    // и будет освобождён им же. other снова занимает свой встроенный буфер
+    void StealHeapBuffer(SmallVector& other) noexcept
+    {
+        assert(!other.IsInline());
+        Base::Adopt(other.Base::Release());
+        other.Base::Reserve(N);
+    }
+};
+
+// Удаляет из SmallVector все элементы, удовлетворяющие предикату (см. EraseIf для Vector)
+template <typename T, size_t N, typename Upstream, typename GrowthPolicy, typename Predicate>
+size_t EraseIf(SmallVector<T, N, Upstream, GrowthPolicy>& v, Predicate pred)
+{
+    auto new_end = std::remove_if(v.begin(), v.end(), pred);
+    const size_t removed = std::distance(new_end, v.end());
+    v.Erase(new_end, v.end());
+    return removed;
+}
+
+// Удаляет из SmallVector все элементы, равные value
+template <typename T, size_t N, typename Upstream, typename GrowthPolicy, typename U>
+size_t Erase(SmallVector<T, N, Upstream, GrowthPolicy>& v, const U& value)
+{
+    return EraseIf(v, [&value](const T& elem)
+                   {
+                       return elem == value;
+                   });
+}
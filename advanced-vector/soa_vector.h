@@ -0,0 +1,639 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+/*
+SoaVector<A, B, C...> хранит последовательность записей (a, b, c...) "по столбцам"
+(struct of arrays): каждое поле — в отдельном буфере RawMemory. Цикл, читающий
+одно поле, обходит непрерывный массив только этого поля, поэтому каждая
+загруженная кэш-линия используется целиком, а компилятор может векторизовать цикл.
+
+Все столбцы имеют общие размер и вместимость и растут вместе по одной политике
+GrowthPolicy (см. BasicSoaVector). Рост, как и в Vector, даёт строгую гарантию
+безопасности исключений: новые буферы всех столбцов выделяются и заполняются
+до того, как освобождаются старые, а столбцы, которые переносятся перемещением,
+перемещаются только после того, как скопированы все остальные.
+
+Доступ к данным:
+-Column<I>() — столбец I как непрерывный диапазон (SoaColumn, в C++20 приводится к std::span);
+-Get<I>(index) — поле I записи index;
+-begin()/end() — итератор по записям, разыменование которого даёт кортеж ссылок
+ std::tuple<A&, B&, C&...> (прокси-объект, как у std::vector<bool>).
+*/
+
+// Непрерывный диапазон элементов одного столбца SoaVector
+template <typename T>
+class SoaColumn
+{
+public:
+    using iterator = T*;
+    using value_type = std::remove_const_t<T>;
+
+    SoaColumn(T* data, size_t size) noexcept
+        : data_(data)
+        , size_(size)
+    {}
+
+    T* Data() const noexcept
+    {
+        return data_;
+    }
+
+    size_t Size() const noexcept
+    {
+        return size_;
+    }
+
+    T& operator[](size_t index) const noexcept
+    {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    T* begin() const noexcept
+    {
+        return data_;
+    }
+
+    T* end() const noexcept
+    {
+        return data_ + size_;
+    }
+
+#if defined(__cpp_lib_span)
+    operator std::span<T>() const noexcept
+    {
+        return std::span<T>(data_, size_);
+    }
+#endif
+
+private:
+    T* data_;
+    size_t size_;
+};
+
+template <typename GrowthPolicy, typename... Fields>
+class BasicSoaVector
+{
+    static_assert(sizeof...(Fields) > 0, "SoaVector requires at least one field");
+
+    using Columns = std::tuple<RawMemory<Fields>...>;
+
+    template <size_t I>
+    using Field = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    template <bool IS_CONST>
+    class BasicIterator;
+
+public:
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+    using reference = std::tuple<Fields&...>;
+    using const_reference = std::tuple<const Fields&...>;
+    using growth_policy = GrowthPolicy;
+
+    static constexpr size_t FIELD_COUNT = sizeof...(Fields);
+
+    BasicSoaVector() = default;
+
+    explicit BasicSoaVector(size_t size)
+    {
+        Resize(size);
+    }
+
+    BasicSoaVector(const BasicSoaVector& other)
+        : columns_(AllocateColumns(other.size_))
+    {
+        CopyColumns<0>(other);
+        size_ = other.size_;
+    }
+
+    BasicSoaVector(BasicSoaVector&& other) noexcept
+    {
+        Swap(other);
+    }
+
+    ~BasicSoaVector()
+    {
+        DestroyColumns(columns_, 0, size_);
+    }
+
+    BasicSoaVector& operator=(const BasicSoaVector& rhs)
+    {
+        if (this != &rhs)
+        {
+            BasicSoaVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    BasicSoaVector& operator=(BasicSoaVector&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    void Swap(BasicSoaVector& other) noexcept
+    {
+        SwapColumns(other, std::index_sequence_for<Fields...>{});
+        std::swap(size_, other.size_);
+    }
+
+    // Добавляет запись, принимая по одному аргументу конструктора на каждое поле.
+    // Аргументы могут ссылаться на элементы самого контейнера: при росте запись
+    // создаётся в новых буферах раньше, чем переносятся старые элементы
+    template <typename... Args>
+    void EmplaceBack(Args&&... args)
+    {
+        static_assert(sizeof...(Args) == FIELD_COUNT, "EmplaceBack expects one argument per field");
+        auto values = std::forward_as_tuple(std::forward<Args>(args)...);
+        if (size_ < Capacity())
+        {
+            ConstructAt<0>(columns_, size_, values);
+        }
+        else
+        {
+            Columns new_columns = AllocateColumns(NextCapacity(size_ + 1));
+            ConstructAt<0>(new_columns, size_, values);
+            try
+            {
+                RelocateColumns(new_columns);
+            }
+            catch (...)
+            {
+                DestroyColumns(new_columns, size_, size_ + 1);
+                throw;
+            }
+            ReleaseRelocated(new_columns);
+        }
+        ++size_;
+    }
+
+    void PopBack() noexcept
+    {
+        assert(size_ > 0);
+        DestroyColumns(columns_, size_ - 1, size_);
+        --size_;
+    }
+
+    // Выделяет буферы всех столбцов на new_capacity записей
+    void Reserve(size_t new_capacity)
+    {
+        if (new_capacity <= Capacity())
+        {
+            return;
+        }
+        Columns new_columns = AllocateColumns(new_capacity);
+        RelocateColumns(new_columns);
+        ReleaseRelocated(new_columns);
+    }
+
+    // Добавленные записи инициализируются значением во всех столбцах
+    void Resize(size_t new_size)
+    {
+        if (new_size > size_)
+        {
+            Reserve(new_size);
+            ValueConstructColumns<0>(new_size);
+        }
+        else
+        {
+            DestroyColumns(columns_, new_size, size_);
+        }
+        size_ = new_size;
+    }
+
+    size_t Size() const noexcept
+    {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept
+    {
+        return std::get<0>(columns_).Capacity();
+    }
+
+    template <size_t I>
+    SoaColumn<Field<I>> Column() noexcept
+    {
+        return SoaColumn<Field<I>>(std::get<I>(columns_).GetAddress(), size_);
+    }
+
+    template <size_t I>
+    SoaColumn<const Field<I>> Column() const noexcept
+    {
+        return SoaColumn<const Field<I>>(std::get<I>(columns_).GetAddress(), size_);
+    }
+
+    template <size_t I>
+    Field<I>& Get(size_t index) noexcept
+    {
+        assert(index < size_);
+        return std::get<I>(columns_)[index];
+    }
+
+    template <size_t I>
+    const Field<I>& Get(size_t index) const noexcept
+    {
+        assert(index < size_);
+        return std::get<I>(columns_)[index];
+    }
+
+    reference operator[](size_t index) noexcept
+    {
+        assert(index < size_);
+        return RecordAt<reference>(columns_, index, std::index_sequence_for<Fields...>{});
+    }
+
+    const_reference operator[](size_t index) const noexcept
+    {
+        assert(index < size_);
+        return RecordAt<const_reference>(columns_, index, std::index_sequence_for<Fields...>{});
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator(this, 0);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(this, size_);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, size_);
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+private:
+    size_t NextCapacity(size_t required_size) const noexcept
+    {
+        return GrowthPolicy::template NextCapacity<std::tuple<Fields...>, std::allocator<std::tuple<Fields...>>>(
+            Capacity(), required_size);
+    }
+
+    // Если второй или следующий буфер выделить не удалось, уже выделенные освобождаются
+    static Columns AllocateColumns(size_t capacity)
+    {
+        return Columns(RawMemory<Fields>(capacity)...);
+    }
+
+    template <size_t... I>
+    void SwapColumns(BasicSoaVector& other, std::index_sequence<I...>) noexcept
+    {
+        (std::get<I>(columns_).Swap(std::get<I>(other.columns_)), ...);
+    }
+
+    template <typename Reference, typename ColumnsT, size_t... I>
+    static Reference RecordAt(ColumnsT& columns, size_t index, std::index_sequence<I...>) noexcept
+    {
+        return Reference(std::get<I>(columns)[index]...);
+    }
+
+    // Разрушает записи [first, last) во всех столбцах
+    static void DestroyColumns(Columns& columns, size_t first, size_t last) noexcept
+    {
+        std::apply([first, last](auto&... column) {
+            (std::destroy(column + first, column + last), ...);
+        }, columns);
+    }
+
+    // Создаёт поля записи index в столбцах I и далее. При исключении поля,
+    // уже созданные в предыдущих столбцах, разрушаются
+    template <size_t I, typename Values>
+    static void ConstructAt(Columns& columns, size_t index, Values& values)
+    {
+        if constexpr (I < FIELD_COUNT)
+        {
+            Field<I>* slot = std::get<I>(columns) + index;
+            new(slot) Field<I>(std::get<I>(std::move(values)));
+            try
+            {
+                ConstructAt<I + 1>(columns, index, values);
+            }
+            catch (...)
+            {
+                std::destroy_at(slot);
+                throw;
+            }
+        }
+    }
+
+    template <size_t I>
+    void CopyColumns(const BasicSoaVector& other)
+    {
+        if constexpr (I < FIELD_COUNT)
+        {
+            std::uninitialized_copy_n(std::get<I>(other.columns_).GetAddress(), other.size_,
+                                      std::get<I>(columns_).GetAddress());
+            try
+            {
+                CopyColumns<I + 1>(other);
+            }
+            catch (...)
+            {
+                std::destroy_n(std::get<I>(columns_).GetAddress(), other.size_);
+                throw;
+            }
+        }
+    }
+
+    template <size_t I>
+    void ValueConstructColumns(size_t new_size)
+    {
+        if constexpr (I < FIELD_COUNT)
+        {
+            Field<I>* first = std::get<I>(columns_) + size_;
+            std::uninitialized_value_construct_n(first, new_size - size_);
+            try
+            {
+                ValueConstructColumns<I + 1>(new_size);
+            }
+            catch (...)
+            {
+                std::destroy_n(first, new_size - size_);
+                throw;
+            }
+        }
+    }
+
+    // Столбец переносится копированием, если перемещение может выбросить исключение
+    template <typename T>
+    static constexpr bool RELOCATES_BY_COPY = !is_trivially_relocatable_v<T>
+        && !std::is_nothrow_move_constructible_v<T> && std::is_copy_constructible_v<T>;
+
+    /*
+    Переносит size_ записей во все столбцы new_columns так же, как Vector при реаллокации:
+    побайтово, перемещением или копированием. Сначала копируются столбцы, копирование
+    которых может выбросить исключение, и только затем перемещаются остальные.
+    Поэтому исключение при копировании оставляет старые буферы нетронутыми.
+    При исключении созданные копии удаляются
+    */
+    void RelocateColumns(Columns& new_columns)
+    {
+        CopyRelocateColumns<0>(new_columns);
+        try
+        {
+            MoveRelocateColumns<0>(new_columns);
+        }
+        catch (...)
+        {
+            // Бросить может только перемещение столбца, который нельзя скопировать
+            DestroyCopyRelocated<0>(new_columns);
+            throw;
+        }
+    }
+
+    template <size_t I>
+    void CopyRelocateColumns(Columns& new_columns)
+    {
+        if constexpr (I < FIELD_COUNT)
+        {
+            using T = Field<I>;
+            T* to = std::get<I>(new_columns).GetAddress();
+            if constexpr (RELOCATES_BY_COPY<T>)
+            {
+                std::uninitialized_copy_n(std::get<I>(columns_).GetAddress(), size_, to);
+            }
+            try
+            {
+                CopyRelocateColumns<I + 1>(new_columns);
+            }
+            catch (...)
+            {
+                if constexpr (RELOCATES_BY_COPY<T>)
+                {
+                    std::destroy_n(to, size_);
+                }
+                throw;
+            }
+        }
+    }
+
+    template <size_t I>
+    void MoveRelocateColumns(Columns& new_columns)
+    {
+        if constexpr (I < FIELD_COUNT)
+        {
+            using T = Field<I>;
+            T* from = std::get<I>(columns_).GetAddress();
+            T* to = std::get<I>(new_columns).GetAddress();
+            if constexpr (is_trivially_relocatable_v<T>)
+            {
+                if (size_ != 0)
+                {
+                    std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), size_ * sizeof(T));
+                }
+            }
+            else if constexpr (!RELOCATES_BY_COPY<T>)
+            {
+                std::uninitialized_move_n(from, size_, to);
+            }
+            try
+            {
+                MoveRelocateColumns<I + 1>(new_columns);
+            }
+            catch (...)
+            {
+                if constexpr (!is_trivially_relocatable_v<T> && !RELOCATES_BY_COPY<T>)
+                {
+                    std::destroy_n(to, size_);
+                }
+                throw;
+            }
+        }
+    }
+
+    template <size_t I>
+    void DestroyCopyRelocated(Columns& new_columns) noexcept
+    {
+        if constexpr (I < FIELD_COUNT)
+        {
+            if constexpr (RELOCATES_BY_COPY<Field<I>>)
+            {
+                std::destroy_n(std::get<I>(new_columns).GetAddress(), size_);
+            }
+            DestroyCopyRelocated<I + 1>(new_columns);
+        }
+    }
+
+    // Завершает перенос: разрушает исходные элементы и забирает новые буферы
+    void ReleaseRelocated(Columns& new_columns) noexcept
+    {
+        std::apply([this](auto&... column) {
+            (DestroyRelocated(column), ...);
+        }, columns_);
+        std::swap(columns_, new_columns);
+    }
+
+    template <typename T>
+    void DestroyRelocated(RawMemory<T>& column) noexcept
+    {
+        if constexpr (!is_trivially_relocatable_v<T>)
+        {
+            std::destroy_n(column.GetAddress(), size_);
+        }
+    }
+
+    /*
+    Итератор по записям хранит контейнер и индекс записи.
+    Разыменование возвращает кортеж ссылок на поля записи.
+    */
+    template <bool IS_CONST>
+    class BasicIterator
+    {
+        using Container = std::conditional_t<IS_CONST, const BasicSoaVector, BasicSoaVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::tuple<Fields...>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IS_CONST, const_reference, BasicSoaVector::reference>;
+        using pointer = void;
+
+        BasicIterator() = default;
+
+        BasicIterator(Container* container, size_t index) noexcept
+            : container_(container)
+            , index_(index)
+        {}
+
+        reference operator*() const noexcept
+        {
+            return (*container_)[index_];
+        }
+
+        reference operator[](difference_type offset) const noexcept
+        {
+            return (*container_)[index_ + offset];
+        }
+
+        BasicIterator& operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept
+        {
+            BasicIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        BasicIterator& operator--() noexcept
+        {
+            --index_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept
+        {
+            BasicIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept
+        {
+            index_ += offset;
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type offset) noexcept
+        {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept
+        {
+            return it += offset;
+        }
+
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept
+        {
+            return it += offset;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept
+        {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept
+        {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept
+        {
+            return lhs.container_ == rhs.container_ && lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept
+        {
+            return lhs.index_ < rhs.index_;
+        }
+
+        friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept
+        {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept
+        {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept
+        {
+            return !(lhs < rhs);
+        }
+
+    private:
+        Container* container_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    Columns columns_;
+    size_t size_ = 0;
+};
+
+template <typename... Fields>
+using SoaVector = BasicSoaVector<DoublingGrowth, Fields...>;
@@ -1,13 +1,244 @@
 #pragma once
 
 #include <cassert>
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>     // для memcpy / memmove
 #include <new>
 #include <utility>
 #include <memory>
 #include <algorithm>   // для copy_n
+#include <functional>  // для std::less
+#include <initializer_list>
+#include <iterator>
 #include <type_traits>  // для constexpr is_*-функций
 
+#if __has_include(<version>)
+#include <version>     // для макросов __cpp_lib_*
+#endif
+#if defined(__cpp_lib_span)
+#include <span>
+#endif
+
+#include "vector_parallel.h"
+#include "vector_stats.h"
+
+// Помечает медленные пути, которые не нужно встраивать в вызывающий код
+#if defined(__GNUC__) || defined(__clang__)
+#define VECTOR_NOINLINE_COLD [[gnu::noinline, gnu::cold]]
+#elif defined(_MSC_VER)
+#define VECTOR_NOINLINE_COLD __declspec(noinline)
+#else
+#define VECTOR_NOINLINE_COLD
+#endif
+
+/*
+В C++20, когда std::allocator и алгоритмы стандартной библиотеки доступны в constexpr,
+Vector и RawMemory с std::allocator можно использовать при вычислениях на этапе
+компиляции, например, чтобы строить таблицы поиска:
+
+    constexpr std::array<int, 256> TABLE = [] {
+        Vector<int> v;
+        ...
+        std::array<int, 256> result{};
+        std::copy(v.begin(), v.end(), result.begin());
+        return result;
+    }();
+
+Память, выделенная при константном вычислении, должна быть освобождена до его
+окончания, поэтому результат копируется в std::array. В constexpr доступны
+конструкторы, присваивания, Reserve, Resize, EmplaceBack, PushBack, PopBack,
+ShrinkToFit, Swap и доступ к элементам. При константном вычислении элементы
+создаются через std::construct_at, а тривиально перемещаемые типы переносятся
+поэлементно, так как memcpy и размещающий new там недоступны. Политика роста
+должна объявлять NextCapacity (и ShrinkCapacity) как constexpr.
+*/
+#if defined(__cpp_lib_constexpr_dynamic_alloc) && defined(__cpp_lib_constexpr_algorithms) \
+    && defined(__cpp_lib_is_constant_evaluated)
+#define VECTOR_CONSTEXPR constexpr
+#define VECTOR_HAS_CONSTEXPR 1
+#else
+#define VECTOR_CONSTEXPR
+#endif
+
+// Выполняется ли код при вычислении на этапе компиляции
+constexpr bool VectorIsConstantEvaluated() noexcept
+{
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+/*
+Тип T тривиально перемещаем, если перенос объекта в другую область памяти
+побайтовым копированием с последующим "забыванием" исходного объекта (без вызова
+его деструктора) эквивалентен перемещению и разрушению исходника.
+По умолчанию таковыми считаются тривиально копируемые типы. Пользовательские
+типы (например, обёртки над владеющими указателями) можно включить явно:
+
+    template <>
+    struct is_trivially_relocatable<MyHandle> : std::true_type {};
+
+Для таких типов Vector переносит элементы при реаллокации одним memcpy,
+а сдвигает хвост в Emplace и Erase одним memmove. Кроме того, буфер таких
+элементов можно расширять через realloc-подобную операцию аллокатора.
+*/
+template <typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>>
+{};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+/*
+Необязательные расширения аллокатора, позволяющие расти без копирования буфера:
+-bool try_expand(T* p, size_t old_n, size_t new_n) noexcept — пытается расширить
+ блок p на месте, не перемещая его. Годится для элементов любого типа;
+-T* reallocate(T* p, size_t old_n, size_t new_n) — расширяет блок в духе realloc,
+ возможно перенеся его содержимое побайтово. При неудаче бросает std::bad_alloc,
+ оставляя блок p нетронутым. Используется только для тривиально перемещаемых T;
+-T* try_allocate(size_t n) noexcept — то же, что allocate, но при нехватке памяти
+ возвращает nullptr вместо исключения. Vector::TryReserve с таким аллокатором
+ сообщает о неудаче без исключений.
+*/
+template <typename Alloc, typename T, typename = void>
+struct allocator_has_try_expand : std::false_type
+{};
+
+template <typename Alloc, typename T>
+struct allocator_has_try_expand<Alloc, T, std::void_t<decltype(std::declval<Alloc&>().try_expand(
+    std::declval<T*>(), size_t{}, size_t{}))>> : std::true_type
+{};
+
+template <typename Alloc, typename T, typename = void>
+struct allocator_has_reallocate : std::false_type
+{};
+
+template <typename Alloc, typename T>
+struct allocator_has_reallocate<Alloc, T, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+    std::declval<T*>(), size_t{}, size_t{}))>> : std::true_type
+{};
+
+template <typename Alloc, typename T, typename = void>
+struct allocator_has_try_allocate : std::false_type
+{};
+
+template <typename Alloc, typename T>
+struct allocator_has_try_allocate<Alloc, T, std::void_t<decltype(std::declval<Alloc&>().try_allocate(size_t{}))>>
+    : std::true_type
+{};
+
+/*
+Выравнивание буфера, которое гарантирует аллокатор: Alloc::alignment, если он его
+объявляет (см. AlignedAllocator), иначе только alignof(T). RawMemory сообщает это
+выравнивание компилятору через AssumeAligned, чтобы циклы по begin()/end()
+векторизовались без проверок выравнивания.
+*/
+template <typename Alloc, typename = void>
+struct allocator_alignment
+    : std::integral_constant<size_t, alignof(typename std::allocator_traits<Alloc>::value_type)>
+{};
+
+template <typename Alloc>
+struct allocator_alignment<Alloc, std::void_t<decltype(Alloc::alignment)>>
+    : std::integral_constant<size_t, std::max(static_cast<size_t>(Alloc::alignment),
+                                              alignof(typename std::allocator_traits<Alloc>::value_type))>
+{};
+
+template <size_t ALIGNMENT, typename T>
+[[nodiscard]] inline VECTOR_CONSTEXPR T* AssumeAligned(T* ptr) noexcept
+{
+    static_assert(ALIGNMENT != 0 && (ALIGNMENT & (ALIGNMENT - 1)) == 0, "alignment must be a power of two");
+    if (VectorIsConstantEvaluated())
+    {
+        return ptr;
+    }
+#if defined(__cpp_lib_assume_aligned)
+    return std::assume_aligned<ALIGNMENT>(ptr);
+#elif defined(__GNUC__)
+    return static_cast<T*>(__builtin_assume_aligned(ptr, ALIGNMENT));
+#else
+    return ptr;
+#endif
+}
+
+/*
+Создание элементов в неинициализированной памяти. Вне константных вычислений
+используются uninitialized-алгоритмы (копирование и перенос — через VectorParallel),
+при константном вычислении элементы создаются по одному через std::construct_at.
+Как и uninitialized-алгоритмы, при исключении функции разрушают уже созданные элементы.
+*/
+template <typename T>
+struct VectorUninitialized
+{
+    template <typename... Args>
+    static VECTOR_CONSTEXPR T* ConstructAt(T* ptr, Args&&... args)
+    {
+#if defined(VECTOR_HAS_CONSTEXPR)
+        return std::construct_at(ptr, std::forward<Args>(args)...);
+#else
+        return new(ptr) T(std::forward<Args>(args)...);
+#endif
+    }
+
+    static VECTOR_CONSTEXPR void ValueConstructN(T* to, size_t n)
+    {
+        if (VectorIsConstantEvaluated())
+        {
+            ConstructEach(to, n, [](T* dest) {
+                ConstructAt(dest);
+            });
+            return;
+        }
+        std::uninitialized_value_construct_n(to, n);
+    }
+
+    static VECTOR_CONSTEXPR void CopyN(const T* from, size_t n, T* to)
+    {
+        if (VectorIsConstantEvaluated())
+        {
+            ConstructEach(to, n, [from, to](T* dest) {
+                ConstructAt(dest, from[dest - to]);
+            });
+            return;
+        }
+        VectorParallel<T>::UninitializedCopyN(from, n, to);
+    }
+
+    static VECTOR_CONSTEXPR void MoveN(T* from, size_t n, T* to)
+    {
+        if (VectorIsConstantEvaluated())
+        {
+            ConstructEach(to, n, [from, to](T* dest) {
+                ConstructAt(dest, std::move(from[dest - to]));
+            });
+            return;
+        }
+        VectorParallel<T>::UninitializedMoveN(from, n, to);
+    }
+
+private:
+    template <typename Construct>
+    static VECTOR_CONSTEXPR void ConstructEach(T* to, size_t n, Construct construct)
+    {
+        size_t i = 0;
+        try
+        {
+            for (; i < n; ++i)
+            {
+                construct(to + i);
+            }
+        }
+        catch (...)
+        {
+            std::destroy_n(to, i);
+            throw;
+        }
+    }
+};
+
 /*
 Согласно идиоме RAII, жизненный цикл ресурса, который программа 
 получает во временное пользование, должен привязываться ко времени 
@@ -21,16 +252,32 @@
 Выделив код, управляющий сырой памятью, в отдельный класс - обёртку, 
 можно упростить класс Vector.
 Шаблонный класс RawMemory будет отвечать за хранение буфера, который 
-вмещает заданное количество элементов, и предоставлять доступ к элементам по индексу
+вмещает заданное количество элементов, и предоставлять доступ к элементам по индексу.
+
+Память выделяется через аллокатор Alloc, совместимый с std::allocator_traits.
+Аллокатор хранится вместе с буфером: при обмене и перемещении RawMemory он
+переходит вместе с памятью, которую выделил, поэтому буфер всегда освобождается
+тем же аллокатором, которым был получен.
 */
-template <typename T>
+template <typename T, typename Alloc = std::allocator<T>>
 class RawMemory
 {
 public:
+    using allocator_type = Alloc;
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>,
+                  "Alloc::value_type must be the same as T");
+
     RawMemory() = default;
 
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
+    VECTOR_CONSTEXPR explicit RawMemory(const Alloc& alloc) noexcept
+        : alloc_(alloc)
+    {}
+
+    VECTOR_CONSTEXPR explicit RawMemory(size_t capacity, const Alloc& alloc = Alloc())
+        : alloc_(alloc)
+        , buffer_(Allocate(capacity))
         , capacity_(capacity)
     {}
 
@@ -48,118 +295,396 @@ public:
    /*
    Перемещающие конструктор и оператор присваивания не выбрасывают 
    исключений и выполняются за O(1).
+   Перемещающее присваивание освобождает текущий буфер и забирает буфер
+   вместе с аллокатором у rhs.
    */
-    RawMemory(RawMemory&& other) noexcept
-    {
-        Swap(other);
-    }
+    VECTOR_CONSTEXPR RawMemory(RawMemory&& other) noexcept
+        : alloc_(std::move(other.alloc_))
+        , buffer_(std::exchange(other.buffer_, nullptr))
+        , capacity_(std::exchange(other.capacity_, 0))
+    {}
 
-    RawMemory& operator=(RawMemory&& rhs) noexcept
+    VECTOR_CONSTEXPR RawMemory& operator=(RawMemory&& rhs) noexcept
     {
-        Swap(rhs);
+        if (this != &rhs)
+        {
+            Deallocate(buffer_);
+            alloc_ = std::move(rhs.alloc_);
+            buffer_ = std::exchange(rhs.buffer_, nullptr);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+        }
         return *this;
     }
 
-    ~RawMemory()
+    VECTOR_CONSTEXPR ~RawMemory()
     {
         Deallocate(buffer_);
     }
 
-    T* operator+(size_t offset) noexcept
+    VECTOR_CONSTEXPR T* operator+(size_t offset) noexcept
     {
         // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
         assert(offset <= capacity_);
-        return buffer_ + offset;
+        return GetAddress() + offset;
     }
 
-    const T* operator+(size_t offset) const noexcept
+    VECTOR_CONSTEXPR const T* operator+(size_t offset) const noexcept
     {
         return const_cast<RawMemory&>(*this) + offset;
     }
 
-    const T& operator[](size_t index) const noexcept
+    VECTOR_CONSTEXPR const T& operator[](size_t index) const noexcept
     {
         return const_cast<RawMemory&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept
+    VECTOR_CONSTEXPR T& operator[](size_t index) noexcept
     {
         assert(index < capacity_);
-        return buffer_[index];
+        return GetAddress()[index];
+    }
+
+    // Отдаёт буфер вызывающему, не освобождая его. Освободить буфер нужно
+    // аллокатором, равным GetAllocator()
+    [[nodiscard]] VECTOR_CONSTEXPR T* Release() noexcept
+    {
+        capacity_ = 0;
+        return std::exchange(buffer_, nullptr);
+    }
+
+    // Освобождает текущий буфер и становится владельцем buffer на capacity элементов,
+    // выделенного аллокатором, равным GetAllocator()
+    VECTOR_CONSTEXPR void Adopt(T* buffer, size_t capacity) noexcept
+    {
+        assert(buffer != nullptr || capacity == 0);
+        Deallocate(buffer_);
+        buffer_ = buffer;
+        capacity_ = capacity;
     }
 
-    void Swap(RawMemory& other) noexcept
+    // Обменивает буферы вместе с аллокаторами, которыми они были выделены
+    VECTOR_CONSTEXPR void Swap(RawMemory& other) noexcept
     {
+        using std::swap;
+        swap(alloc_, other.alloc_);
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
     }
 
-    const T* GetAddress() const noexcept
+    // Выравнивание буфера, на которое может рассчитывать компилятор
+    static constexpr size_t ALIGNMENT = allocator_alignment<Alloc>::value;
+
+    VECTOR_CONSTEXPR const T* GetAddress() const noexcept
     {
-        return buffer_;
+        return AssumeAligned<ALIGNMENT>(static_cast<const T*>(buffer_));
     }
 
-    T* GetAddress() noexcept
+    VECTOR_CONSTEXPR T* GetAddress() noexcept
     {
-        return buffer_;
+        return AssumeAligned<ALIGNMENT>(buffer_);
     }
 
-    size_t Capacity() const
+    VECTOR_CONSTEXPR size_t Capacity() const
     {
         return capacity_;
     }
 
+    VECTOR_CONSTEXPR const Alloc& GetAllocator() const noexcept
+    {
+        return alloc_;
+    }
+
+    // Можно ли расширять буфер операцией Reallocate
+    static constexpr bool CAN_REALLOCATE = is_trivially_relocatable_v<T> && allocator_has_reallocate<Alloc, T>::value;
+
+    // Пытается увеличить вместимость до new_capacity, не перемещая буфер.
+    // Возвращает false, если аллокатор этого не умеет или блок расширить нельзя
+    VECTOR_CONSTEXPR bool TryExpand(size_t new_capacity) noexcept
+    {
+        if constexpr (allocator_has_try_expand<Alloc, T>::value)
+        {
+            if (buffer_ != nullptr && new_capacity > capacity_
+                && alloc_.try_expand(buffer_, capacity_, new_capacity))
+            {
+                capacity_ = new_capacity;
+                VectorStatsRecorder<T>::OnInPlaceGrowth(new_capacity);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Увеличивает вместимость до new_capacity realloc-подобной операцией аллокатора.
+    // Содержимое буфера переносится побайтово, поэтому доступно только для тривиально
+    // перемещаемых T. При исключении буфер остаётся прежним
+    void Reallocate(size_t new_capacity)
+    {
+        static_assert(CAN_REALLOCATE, "Reallocate requires trivially relocatable T and Alloc::reallocate");
+        assert(new_capacity > capacity_);
+        if (buffer_ == nullptr)
+        {
+            buffer_ = Allocate(new_capacity);
+        }
+        else
+        {
+            buffer_ = alloc_.reallocate(buffer_, capacity_, new_capacity);
+            VectorStatsRecorder<T>::OnInPlaceGrowth(new_capacity);
+        }
+        capacity_ = new_capacity;
+    }
+
+    // Выделяет буфер на capacity элементов пустому RawMemory. При нехватке памяти
+    // возвращает false, оставляя RawMemory пустым
+    bool TryAllocate(size_t capacity) noexcept
+    {
+        assert(buffer_ == nullptr);
+        if (capacity == 0)
+        {
+            return true;
+        }
+        if constexpr (allocator_has_try_allocate<Alloc, T>::value)
+        {
+            buffer_ = alloc_.try_allocate(capacity);
+            if (buffer_ == nullptr)
+            {
+                return false;
+            }
+            VectorStatsRecorder<T>::OnAllocate(capacity);
+        }
+        else
+        {
+            try
+            {
+                buffer_ = Allocate(capacity);
+            }
+            catch (const std::bad_alloc&)
+            {
+                return false;
+            }
+        }
+        capacity_ = capacity;
+        return true;
+    }
+
 private:
     // Выделяет сырую память под n элементов и возвращает указатель на неё
-    static T* Allocate(size_t n)
+    VECTOR_CONSTEXPR T* Allocate(size_t n)
     {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+        if (n == 0)
+        {
+            return nullptr;
+        }
+        T* result = AllocTraits::allocate(alloc_, n);
+        VectorStatsRecorder<T>::OnAllocate(n);
+        return result;
     }
 
     // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
-    static void Deallocate(T* buf) noexcept
+    VECTOR_CONSTEXPR void Deallocate(T* buf) noexcept
     {
-        operator delete(buf);
+        if (buf != nullptr)
+        {
+            AllocTraits::deallocate(alloc_, buf, capacity_);
+            VectorStatsRecorder<T>::OnDeallocate();
+        }
     }
 
+    Alloc alloc_;
     T* buffer_ = nullptr;
     size_t capacity_ = 0;
 };
 
 
+/*
+Политики роста определяют, какую вместимость выделять, когда в буфере не осталось
+места. Политика — это тип со статической функцией
+
+    template <typename T, typename Alloc>
+    static constexpr size_t NextCapacity(size_t capacity, size_t required_size);
+
+возвращающей новую вместимость не меньше required_size. Все реаллоцирующие
+операции Vector получают вместимость только через политику.
+
+DoublingGrowth повторяет прежнее поведение: 1, 2, 4, 8...
+OneAndHalfGrowth растёт в 1.5 раза: сумма ранее освобождённых блоков со временем
+превышает размер очередного запроса, и аллокатор может переиспользовать эту память.
+MinCapacityGrowth<Base> не даёт первой вместимости быть меньше одной кэш-линии элементов.
+SizeClassGrowth<Base> округляет размер буфера вверх до класса размеров аллокатора:
+Alloc::good_size(bytes), если он есть, иначе до степени двойки. Так хвост блока,
+который аллокатор всё равно бы выделил, становится вместимостью вектора.
+*/
+struct DoublingGrowth
+{
+    template <typename T, typename Alloc>
+    static constexpr size_t NextCapacity(size_t capacity, size_t required_size) noexcept
+    {
+        return std::max(required_size, capacity == 0 ? size_t{ 1 } : capacity * 2);
+    }
+};
+
+struct OneAndHalfGrowth
+{
+    template <typename T, typename Alloc>
+    static constexpr size_t NextCapacity(size_t capacity, size_t required_size) noexcept
+    {
+        return std::max(required_size, capacity + (capacity + 1) / 2);
+    }
+};
+
+template <typename Base = DoublingGrowth, size_t CACHE_LINE_SIZE = 64>
+struct MinCapacityGrowth
+{
+    template <typename T, typename Alloc>
+    static constexpr size_t NextCapacity(size_t capacity, size_t required_size) noexcept
+    {
+        constexpr size_t MIN_CAPACITY = sizeof(T) < CACHE_LINE_SIZE ? CACHE_LINE_SIZE / sizeof(T) : 1;
+        return std::max(MIN_CAPACITY, Base::template NextCapacity<T, Alloc>(capacity, required_size));
+    }
+};
+
+/*
+Политика роста может также уменьшать вместимость. Для этого она объявляет
+
+    template <typename T, typename Alloc>
+    static constexpr size_t ShrinkCapacity(size_t capacity, size_t size);
+
+возвращающую новую вместимость (не меньше size) или capacity, если уменьшать не нужно.
+Vector вызывает её после PopBack, Erase и уменьшающего Resize.
+
+ShrinkingGrowth<Base> освобождает память, когда размер падает ниже 1/SHRINK_DIVISOR
+вместимости, и оставляет после этого вдвое больше места, чем занято. Между порогами
+роста (заполнение) и уменьшения (1/SHRINK_DIVISOR) остаётся зазор, поэтому вектор,
+размер которого колеблется около одного из порогов, не перевыделяет память на каждой операции.
+Буферы не больше MIN_CAPACITY элементов не уменьшаются.
+*/
+template <typename Base = DoublingGrowth, size_t SHRINK_DIVISOR = 4, size_t MIN_CAPACITY = 16>
+struct ShrinkingGrowth : Base
+{
+    static_assert(SHRINK_DIVISOR > 2, "shrink threshold must be below the capacity left after shrinking");
+
+    template <typename T, typename Alloc>
+    static constexpr size_t ShrinkCapacity(size_t capacity, size_t size) noexcept
+    {
+        if (capacity <= MIN_CAPACITY || size >= capacity / SHRINK_DIVISOR)
+        {
+            return capacity;
+        }
+        return std::min(capacity, std::max(size * 2, MIN_CAPACITY));
+    }
+};
+
+template <typename Policy, typename T, typename Alloc, typename = void>
+struct growth_policy_can_shrink : std::false_type
+{};
+
+template <typename Policy, typename T, typename Alloc>
+struct growth_policy_can_shrink<Policy, T, Alloc, std::void_t<decltype(
+    Policy::template ShrinkCapacity<T, Alloc>(size_t{}, size_t{}))>> : std::true_type
+{};
+
+template <typename Alloc, typename = void>
+struct allocator_has_good_size : std::false_type
+{};
+
+template <typename Alloc>
+struct allocator_has_good_size<Alloc, std::void_t<decltype(Alloc::good_size(size_t{}))>> : std::true_type
+{};
+
+template <typename Base = DoublingGrowth>
+struct SizeClassGrowth
+{
+    template <typename T, typename Alloc>
+    static constexpr size_t NextCapacity(size_t capacity, size_t required_size) noexcept
+    {
+        const size_t new_capacity = Base::template NextCapacity<T, Alloc>(capacity, required_size);
+        if (new_capacity > static_cast<size_t>(-1) / 2 / sizeof(T))
+        {
+            return new_capacity;
+        }
+        size_t bytes = new_capacity * sizeof(T);
+        if constexpr (allocator_has_good_size<Alloc>::value)
+        {
+            bytes = Alloc::good_size(bytes);
+        }
+        else
+        {
+            size_t size_class = 1;
+            while (size_class < bytes)
+            {
+                size_class *= 2;
+            }
+            bytes = size_class;
+        }
+        return std::max(new_capacity, bytes / sizeof(T));
+    }
+};
+
+
+// Буфер, который Vector::Release передаёт новому владельцу: первые size ячеек
+// содержат созданные элементы, память выделена на capacity элементов
 template <typename T>
+struct VectorBuffer
+{
+    T* data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+// Тег для конструктора Vector(size, default_init): элементы инициализируются
+// по умолчанию, а не значением
+struct default_init_t
+{
+    explicit default_init_t() = default;
+};
+
+inline constexpr default_init_t default_init{};
+
+/*
+Vector учитывает свойства аллокатора так же, как стандартные контейнеры:
+-копирующий конструктор берёт аллокатор из select_on_container_copy_construction;
+-присваивания и Swap передают аллокатор, только если это разрешено
+ propagate_on_container_copy_assignment / _move_assignment / _swap;
+-если аллокатор не передаётся и не равен аллокатору источника, перемещающее
+ присваивание перемещает элементы поштучно в собственную память.
+Элементы по-прежнему создаются размещающим new и uninitialized-алгоритмами,
+поэтому Alloc::construct / Alloc::destroy не вызываются.
+Вместимость при росте выбирает политика GrowthPolicy (см. DoublingGrowth).
+*/
+template <typename T, typename Alloc = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
 class Vector
 {
 public:
     using iterator = T*;
     using const_iterator = const T*;
+    using allocator_type = Alloc;
+    using growth_policy = GrowthPolicy;
 
-    iterator begin() noexcept
+    VECTOR_CONSTEXPR iterator begin() noexcept
     {
         return data_.GetAddress();
     }
 
-    iterator end() noexcept
+    VECTOR_CONSTEXPR iterator end() noexcept
     {
         return data_.GetAddress() + size_;
     }
 
-    const_iterator begin() const noexcept
+    VECTOR_CONSTEXPR const_iterator begin() const noexcept
     {
         return data_.GetAddress();
     }
 
-    const_iterator end() const noexcept
+    VECTOR_CONSTEXPR const_iterator end() const noexcept
     {
         return data_.GetAddress() + size_;
     }
 
-    const_iterator cbegin() const noexcept
+    VECTOR_CONSTEXPR const_iterator cbegin() const noexcept
     {
         return data_.GetAddress();
     }
 
-    const_iterator cend() const noexcept
+    VECTOR_CONSTEXPR const_iterator cend() const noexcept
     {
         return data_.GetAddress() + size_;
     }
@@ -167,11 +692,24 @@ public:
 
     Vector() = default;
 
-    explicit Vector(size_t size)
-        : data_(size)
+    VECTOR_CONSTEXPR explicit Vector(const Alloc& alloc) noexcept
+        : data_(alloc)
+    {}
+
+    VECTOR_CONSTEXPR explicit Vector(size_t size, const Alloc& alloc = Alloc())
+        : data_(size, alloc)
+        , size_(size)  //
+    {
+        VectorUninitialized<T>::ValueConstructN(data_.GetAddress(), size);
+    }
+
+    // Создаёт size элементов инициализацией по умолчанию: для тривиальных типов
+    // память не заполняется нулями и может быть сразу перезаписана, например, read()
+    Vector(size_t size, default_init_t, const Alloc& alloc = Alloc())
+        : data_(size, alloc)
         , size_(size)  //
     {
-        std::uninitialized_value_construct_n(data_.GetAddress(), size);
+        std::uninitialized_default_construct_n(data_.GetAddress(), size);
     }
 
     /*
@@ -180,11 +718,15 @@ public:
     оригинального контейнера, используя функцию CopyConstruct
     Заменено на: std::uninitialized_copy_n
     */
-    Vector(const Vector& other)
-        : data_(other.size_)
+    VECTOR_CONSTEXPR Vector(const Vector& other)
+        : Vector(other, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator()))
+    {}
+
+    VECTOR_CONSTEXPR Vector(const Vector& other, const Alloc& alloc)
+        : data_(other.size_, alloc)
         , size_(other.size_)  //
     {
-        std::uninitialized_copy_n(other.data_.GetAddress(), size_, data_.GetAddress());
+        VectorUninitialized<T>::CopyN(other.data_.GetAddress(), size_, data_.GetAddress());
     }
 
     /*
@@ -193,47 +735,82 @@ public:
     исходного вектора. Исходный вектор будет иметь нулевой размер и вместимость 
     и ссылаться на nullptr.
     */
-    Vector(Vector&& other) noexcept
+    VECTOR_CONSTEXPR Vector(Vector&& other) noexcept
+        : data_(std::move(other.data_))
+        , size_(std::exchange(other.size_, 0))
+    {}
+
+    VECTOR_CONSTEXPR ~Vector()
     {
-        data_.Swap(other.data_);
-        std::swap(size_, other.size_);
+        std::destroy_n(data_.GetAddress(), size_);
     }
 
-    ~Vector()
+    // Копирующее присваивание переиспользует буфер, если его вместимости хватает,
+    // и иначе выделяет новый буфер ровно один раз (см. AssignCopies)
+    VECTOR_CONSTEXPR Vector& operator=(const Vector& rhs)
     {
-        std::destroy_n(data_.GetAddress(), size_);
+        if (this != &rhs)
+        {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value)
+            {
+                if (data_.GetAllocator() != rhs.data_.GetAllocator())
+                {
+                    // Текущий буфер нельзя переиспользовать: вместе с элементами
+                    // приёмник получает аллокатор источника
+                    RawMemory<T, Alloc> new_data(rhs.size_, rhs.data_.GetAllocator());
+                    VectorUninitialized<T>::CopyN(rhs.data_.GetAddress(), rhs.size_, new_data.GetAddress());
+                    std::destroy_n(data_.GetAddress(), size_);
+                    data_ = std::move(new_data);
+                    size_ = rhs.size_;
+                    return *this;
+                }
+            }
+
+            AssignCopies(rhs.data_.GetAddress(), rhs.size_);
+        }
+        return *this;
     }
 
-    // Оператор присваивания, основанный на идиоме copy-and-swap
-    Vector& operator=(const Vector& rhs)
+    VECTOR_CONSTEXPR Vector& operator=(Vector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                             || AllocTraits::is_always_equal::value)
     {
         if (this != &rhs)
         {
-            // Более оптимальная стратегия — применять copy-and-swap только 
-            // когда вместимости вектора-приёмника не хватает, чтобы вместить 
-            // все элементы вектора-источника
-            if (data_.Capacity() < rhs.size_)
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value
+                          || AllocTraits::is_always_equal::value)
+            {
+                // Буферы меняются вместе со своими аллокаторами
+                data_.Swap(rhs.data_);
+                std::swap(size_, rhs.size_);
+            }
+            else if (data_.GetAllocator() == rhs.data_.GetAllocator())
+            {
+                data_.Swap(rhs.data_);
+                std::swap(size_, rhs.size_);
+            }
+            else if (data_.Capacity() < rhs.size_)
             {
-                // capacity источника (rhs) больше емкости приемника.
-                Vector rhs_copy(rhs);
-                Swap(rhs_copy);
+                // Аллокатор не передаётся, а память rhs нельзя освободить нашим
+                // аллокатором. Перемещаем элементы поштучно в собственный буфер
+                RawMemory<T, Alloc> new_data(rhs.size_, data_.GetAllocator());
+                VectorUninitialized<T>::MoveN(rhs.data_.GetAddress(), rhs.size_, new_data.GetAddress());
+                std::destroy_n(data_.GetAddress(), size_);
+                data_.Swap(new_data);
+                size_ = rhs.size_;
             }
             else
             {
-                // capacity источника (rhs) меньше или равен емкости приемника. Избегаем лишнего копирования.
+                // Вместимости хватает: перемещаем элементы поштучно в текущий буфер
+                const size_t common_size = std::min(size_, rhs.size_);
+                std::move(rhs.data_.GetAddress(), rhs.data_.GetAddress() + common_size, data_.GetAddress());
                 if (size_ > rhs.size_)
                 {
-                    // В текущем векторе элементов больше, чем в rhs
-                    std::copy_n(rhs.data_.GetAddress(), rhs.size_, data_.GetAddress());
                     std::destroy_n(data_.GetAddress() + rhs.size_, size_ - rhs.size_);
                 }
                 else
                 {
-                    // В текущем векторе элементов меньше или равно, чем в rhs
-                    std::copy_n(rhs.data_.GetAddress(), size_, data_.GetAddress());
-                    std::uninitialized_copy_n(rhs.data_.GetAddress() + size_,
-                                              rhs.size_ - size_,
-                                              data_.GetAddress() + size_);
+                    VectorUninitialized<T>::MoveN(rhs.data_.GetAddress() + size_, rhs.size_ - size_,
+                                                  data_.GetAddress() + size_);
                 }
                 size_ = rhs.size_;
             }
@@ -241,15 +818,6 @@ public:
         return *this;
     }
 
-    Vector& operator=(Vector&& rhs) noexcept
-    {
-        if (this != &rhs)
-        {
-            Swap(rhs);
-        }
-        return *this;
-    }
-
     // Метод Resize должен предоставлять строгую гарантию безопасности исключений, 
     // когда выполняется любое из условий:
     // -move-конструктор у типа T объявлен как noexcept;
@@ -260,13 +828,13 @@ public:
     // Сложность метода Resize должна линейно зависеть от разницы между текущим 
     // и новым размером вектора. Если новый размер превышает текущую вместимость вектора,
     // сложность операции может дополнительно линейно зависеть от текущего размера вектора.
-    void Resize(size_t new_size)
+    VECTOR_CONSTEXPR void Resize(size_t new_size)
     {
         if (new_size > size_)
         {
             // увеличиваем размер и инициализируем добавленные элементы
             Reserve(new_size);
-            std::uninitialized_value_construct_n(data_.GetAddress() + size_, new_size - size_);
+            VectorUninitialized<T>::ValueConstructN(data_.GetAddress() + size_, new_size - size_);
             size_ = new_size;
         }
         else if (new_size < size_)
@@ -274,10 +842,45 @@ public:
             // уменьшаем размер, удаляя лишнее
             std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
             size_ = new_size;
+            MaybeShrink();
         }
         // Если new_size == size_, то ничего не делаем
     }
 
+    // То же, что Resize, но добавленные элементы инициализируются по умолчанию,
+    // а не значением: для тривиальных типов их содержимое не определено
+    void ResizeDefaultInit(size_t new_size)
+    {
+        if (new_size > size_)
+        {
+            Reserve(new_size);
+            std::uninitialized_default_construct_n(data_.GetAddress() + size_, new_size - size_);
+            size_ = new_size;
+        }
+        else
+        {
+            Resize(new_size);
+        }
+    }
+
+    // Аналог std::basic_string::resize_and_overwrite из C++23. Обеспечивает вместимость
+    // не меньше n и вызывает op(data, n), где data указывает на буфер из n элементов:
+    // первые min(Size(), n) из них сохраняют прежние значения, остальные не инициализированы.
+    // op заполняет буфер и возвращает новый размер r <= n.
+    // Если op выбросит исключение, размер вектора станет min(Size(), n).
+    // Доступно только для тривиальных типов, которым не нужны конструкторы и деструкторы
+    template <typename Operation>
+    void ResizeAndOverwrite(size_t n, Operation op)
+    {
+        static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                      "ResizeAndOverwrite requires trivial T");
+        Reserve(n);
+        size_ = std::min(size_, n);
+        const size_t new_size = std::move(op)(data_.GetAddress(), n);
+        assert(new_size <= n);
+        size_ = new_size;
+    }
+
 
     // Метод EmplaceBack должен предоставлять строгую гарантию безопасности 
     // исключений, когда выполняется любое из условий :
@@ -288,47 +891,22 @@ public:
     // гарантию безопасности исключений.
     // Сложность метода EmplaceBack должна быть амортизированной константой.
     template <class... Args>
-    T& EmplaceBack(Args&&... args)
+    VECTOR_CONSTEXPR T& EmplaceBack(Args&&... args)
     {
         // Метод EmplaceBack может вызвать любые конструкторы типа T, в том числе объявленные 
         // explicit. В некоторых случаях это может создать проблемы, которые были бы невозможны 
         // при использовании PushBack. Например, когда внутри вектора хранятся указатели unique_ptr
 
-        // Есть ли место по новый элемент?
+        // Быстрый путь — место есть. Вызываем конструктор непосредственно в буфере.
+        // Рост буфера вынесен в EmplaceGrowing, чтобы этот код встраивался в циклы вызывающего
         if (size_ < Capacity())
         {
-            // Место есть. Память пока не распределена. 
-            // Вызываем конструктор непосредственно в буфере
-            new(data_ + size_) T(std::forward<Args>(args)...);
-            ++size_;
-        }
-        else
-        {
-            // Места больше нет. Выделяем
-            size_t new_capacity = (size_ == 0 ? 1 : size_ * 2);
-            RawMemory<T> new_data(new_capacity);
-            // Создаем новый элемент в новом буфере
-            new(new_data + size_) T(std::forward<Args>(args)...);
-            // Есть ли у типа noexcept-конструктор перемещения ИЛИ отсутствует копирующий конструктор (т.е. есть move-конструктор)
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
-            {
-                // Используем перемещение из старого вектора
-                std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            else
-            {
-                // Тип неперемещаем. Используем копирующий конструктор
-                std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            data_.Swap(new_data);
-            // Вызываем деструкторы у старых элементов
-            std::destroy_n(new_data.GetAddress(), size_);
-            ++size_;
+            VectorUninitialized<T>::ConstructAt(data_ + size_, std::forward<Args>(args)...);
+            return data_[size_++];
         }
-
-        return *(data_.GetAddress() + size_ - 1);
         // Возвращаем ссылку на добавленный элемент, чтобы его можно было сразу использовать
         // cats.EmplaceBack("Tom"s, 5).SayMeow();
+        return EmplaceGrowing<true>(size_, std::forward<Args>(args)...);
     }
 
 
@@ -339,85 +917,35 @@ public:
     // Если у типа T нет конструктора копирования и move-конструктор может выбрасывать 
     // исключения, метод PushBack должен предоставлять базовую гарантию безопасности исключений.
     // Сложность метода PushBack должна быть амортизированной константой.
-    void PushBack(const T& value)
+    VECTOR_CONSTEXPR void PushBack(const T& value)
     {
-        // Есть ли место по новый элемент?
-        if (size_ < Capacity())
-        {
-            // Место есть. Память пока не распределена.
-            new(data_ + size_) T(value);
-            ++size_;
-        }
-        else
-        {
-            // Места больше нет. Выделяем
-            size_t new_capacity = (size_ == 0 ? 1 : size_ * 2);
-            RawMemory<T> new_data(new_capacity);
-            // Создаем новый элемент в новом буфере
-            new (new_data + size_) T(value);
-            // Есть ли у типа noexcept-конструктор перемещения ИЛИ отсутствует копирующий конструктор (т.е. есть move-конструктор)
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
-            {
-                // Используем перемещение из старого вектора
-                std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            else
-            {
-                // Тип неперемещаем. Используем копирующий конструктор
-                std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            data_.Swap(new_data);
-            // Вызываем деструкторы у старых элементов
-            std::destroy_n(new_data.GetAddress(), size_);
-            ++size_;
-        }
+        EmplaceBack(value);
     }
 
     template <typename U>
-    void PushBack(U&& value)
+    VECTOR_CONSTEXPR void PushBack(U&& value)
     {
+        EmplaceBack(std::forward<U>(value));
+    }
 
-        // Есть ли место по новый элемент?
-        if (size_ < Capacity())
-        {
-            // Место есть. Память пока не распределена. Вставляем
-            new(data_ + size_) T(std::forward<U>(value));
-            ++size_;
-        }
-        else
-        {
-            // Места больше нет. Выделяем
-            size_t new_capacity = (size_ == 0 ? 1 : size_ * 2);
-            RawMemory<T> new_data(new_capacity);
-            // Создаем новый элемент в новом буфере
-            new (new_data + size_) T(std::forward<U>(value));
-            // Копируем или перемещаем старый данные в новый буфер
-            // Есть ли у типа noexcept-конструктор перемещения ИЛИ отсутствует копирующий конструктор (т.е. есть move-конструктор)
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
-            {
-                // Используем перемещение из старого вектора
-                std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            else
-            {
-                // Тип неперемещаем. Используем копирующий конструктор
-                std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            // Обмениваем буферы
-            data_.Swap(new_data);
-            // Вызываем деструкторы у старых элементов
-            std::destroy_n(new_data.GetAddress(), size_);
-            ++size_;
-        }
+    // EmplaceBack без проверки вместимости для циклов заполнения после Reserve:
+    // место под элемент должно быть зарезервировано заранее (проверяется только assert)
+    template <class... Args>
+    VECTOR_CONSTEXPR T& EmplaceBackUnchecked(Args&&... args)
+    {
+        assert(size_ < Capacity());
+        VectorUninitialized<T>::ConstructAt(data_ + size_, std::forward<Args>(args)...);
+        return data_[size_++];
     }
 
     // Метод PopBack не должен выбрасывать исключений при вызове у непустого вектора. 
     // При вызове PopBack у пустого вектора поведение неопределённо.
     // Метод PopBack должен иметь сложность $O(1)$.
-    void PopBack() noexcept
+    VECTOR_CONSTEXPR void PopBack() noexcept
     {
         std::destroy_n(data_.GetAddress() + size_ - 1, 1);
         --size_;
+        MaybeShrink();
     }
 
 
@@ -445,160 +973,946 @@ public:
         // Есть ли место по новый элемент?
         if (size_ < Capacity())
         {
-            // Место есть.
-            T inserting_value_tmp = T(std::forward<Args>(args)...);
-            new(data_ + size_) T(std::move(data_[size_ - 1]));
-            std::move_backward(begin() + index, begin() + size_ - 1, begin() + size_);
-            data_[index] = std::move(inserting_value_tmp);
-            ++size_;
-            return begin() + index;
+            EmplaceInCapacity(index, std::forward<Args>(args)...);
         }
         else
         {
-            // Места больше нет. Выделяем
-            size_t new_capacity = (size_ == 0 ? 1 : size_ * 2);
-            RawMemory<T> new_data(new_capacity);
+            EmplaceGrowing<false>(index, std::forward<Args>(args)...);
+        }
+        return begin() + index;
+    }
+
+    iterator Insert(const_iterator pos, const T& value)
+    {
+        return Emplace(pos, value);
+    }
 
-            // Вставляем новое значение в требуемую позицию нового буфера с отступом, эквивалентном pos старого буфера
-            new(new_data.GetAddress() + index) T(std::forward<Args>(args)...);
+    iterator Insert(const_iterator pos, T&& value)
+    {
+        return Emplace(pos, std::move(value));
+    }
 
-            // 2. Пытаемся переместить элементы, предшествующие вставляемому элементу.
-            //    В случае исключений подчищать нужно вручную.
+    // Групповая вставка вычисляет итоговый размер один раз, выполняет не более
+    // одной реаллокации и сдвигает хвост один раз. Если конструирование вставляемых
+    // элементов выбрасывает исключение, вектор остаётся прежним (при реаллокации —
+    // при тех же условиях, что и у Emplace). Итераторы first и last не должны
+    // указывать на элементы самого вектора.
+    // Для однопроходных (input) итераторов элементы добавляются в конец по одному
+    // и затем переставляются в позицию pos.
+    template <typename InputIt, typename = std::enable_if_t<std::is_convertible_v<
+        typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>>>
+    iterator Insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        assert(pos >= begin() && pos <= end());
+        const size_t index = std::distance(cbegin(), pos);
+        if constexpr (std::is_convertible_v<typename std::iterator_traits<InputIt>::iterator_category,
+                                            std::forward_iterator_tag>)
+        {
+            const size_t count = std::distance(first, last);
+            return InsertN(index, count, [&first, count](T* dest)
+                           {
+                               std::uninitialized_copy_n(first, count, dest);
+                           });
+        }
+        else
+        {
+            const size_t old_size = size_;
             try
             {
-                // Есть ли у типа noexcept-конструктор перемещения ИЛИ отсутствует копирующий конструктор (т.е. есть move-конструктор)
-                if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+                for (; first != last; ++first)
                 {
-                    // Используем перемещение из старого вектора по итераторам
-                    std::uninitialized_move(begin(), begin() + index, new_data.GetAddress());
-                }
-                else
-                {
-                    // Тип неперемещаем. Используем копирующий конструктор по итераторам
-                    std::uninitialized_copy(begin(), begin() + index, new_data.GetAddress());
+                    EmplaceBack(*first);
                 }
             }
             catch (...)
             {
-                // Перемещение не получилось. Удаляем элемент из шага 1.
-                std::destroy_at(new_data.GetAddress() + index);
+                // Удаляем уже добавленные элементы
+                std::destroy_n(data_.GetAddress() + old_size, size_ - old_size);
+                size_ = old_size;
+                throw;
             }
+            std::rotate(begin() + index, begin() + old_size, end());
+            return begin() + index;
+        }
+    }
 
-            // 3. Пытаемся переместить элементы, следующие ЗА вставляемым
-            //    В случае исключений подчищать нужно вручную.
-            try
+    iterator Insert(const_iterator pos, size_t count, const T& value)
+    {
+        assert(pos >= begin() && pos <= end());
+        const size_t index = std::distance(cbegin(), pos);
+        if (count == 0)
+        {
+            return begin() + index;
+        }
+        // value может ссылаться на элемент вектора, который будет сдвинут или перемещён
+        const T value_copy(value);
+        return InsertN(index, count, [&value_copy, count](T* dest)
+                       {
+                           std::uninitialized_fill_n(dest, count, value_copy);
+                       });
+    }
+
+    iterator Insert(const_iterator pos, std::initializer_list<T> values)
+    {
+        return Insert(pos, values.begin(), values.end());
+    }
+
+    template <typename InputIt, typename = std::enable_if_t<std::is_convertible_v<
+        typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>>>
+    void Append(InputIt first, InputIt last)
+    {
+        Insert(cend(), first, last);
+    }
+
+    void Append(std::initializer_list<T> values)
+    {
+        Insert(cend(), values.begin(), values.end());
+    }
+
+    // Заменяет элементы вектора копиями [first, last). Для многопроходных итераторов
+    // поведение то же, что у копирующего присваивания: не более одной реаллокации,
+    // memcpy для тривиально копируемых T из непрерывного источника. Однопроходные
+    // итераторы заполняют вектор по одному элементу. Итераторы first и last
+    // не должны указывать на элементы самого вектора.
+    template <typename InputIt, typename = std::enable_if_t<std::is_convertible_v<
+        typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>>>
+    void Assign(InputIt first, InputIt last)
+    {
+        if constexpr (std::is_convertible_v<typename std::iterator_traits<InputIt>::iterator_category,
+                                            std::forward_iterator_tag>)
+        {
+            AssignCopies(first, static_cast<size_t>(std::distance(first, last)));
+        }
+        else
+        {
+            std::destroy_n(data_.GetAddress(), size_);
+            size_ = 0;
+            for (; first != last; ++first)
             {
-                // Есть ли у типа noexcept-конструктор перемещения ИЛИ отсутствует копирующий конструктор (т.е. есть move-конструктор)
-                if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
-                {
-                    // Используем перемещение из старого вектора по итераторам
-                    std::uninitialized_move_n(begin() + index, size_ - index, new_data.GetAddress() + index + 1);
-                }
-                else
-                {
-                    // Тип неперемещаем. Используем копирующий конструктор по итераторам
-                    std::uninitialized_copy_n(begin() + index, size_ - index, new_data.GetAddress() + index + 1);
-                }
+                EmplaceBack(*first);
             }
-            catch (...)
+        }
+    }
+
+    void Assign(std::initializer_list<T> values)
+    {
+        AssignCopies(values.begin(), values.size());
+    }
+
+    // Заменяет элементы вектора count копиями value. value может ссылаться на элемент вектора
+    void Assign(size_t count, const T& value)
+    {
+        if constexpr (RawMemory<T, Alloc>::CAN_REALLOCATE)
+        {
+            // Reallocate может перенести буфер вместе с элементом, на который ссылается value
+            if (data_.Capacity() < count && IsInsideElements(std::addressof(value)))
             {
-                // Перемещение не получилось. Удаляем элементы из шагов 1 и 2.
-                std::destroy(new_data.GetAddress(), new_data.GetAddress() + index + 1);
+                const T copy(value);
+                Assign(count, copy);
+                return;
             }
-
+        }
+        if (data_.Capacity() < count && !GrowWithoutCopy(count))
+        {
+            // Новые элементы создаются до разрушения старых, поэтому value остаётся действительным
+            RawMemory<T, Alloc> new_data(count, data_.GetAllocator());
+            std::uninitialized_fill_n(new_data.GetAddress(), count, value);
+            std::destroy_n(data_.GetAddress(), size_);
             data_.Swap(new_data);
-            std::destroy_n(new_data.GetAddress(), size_);
-            ++size_;
+            size_ = count;
+            return;
+        }
+        // Элемент, на который ссылается value, либо получает то же значение,
+        // либо разрушается после того, как все копии созданы
+        if (size_ > count)
+        {
+            std::fill_n(data_.GetAddress(), count, value);
+            std::destroy_n(data_.GetAddress() + count, size_ - count);
+        }
+        else
+        {
+            std::fill_n(data_.GetAddress(), size_, value);
+            std::uninitialized_fill_n(data_.GetAddress() + size_, count - size_, value);
+        }
+        size_ = count;
+    }
 
+    iterator Erase(const_iterator pos)   /*noexcept(std::is_nothrow_move_assignable_v<T>)*/
+    {
+        assert(pos >= begin() && pos < end());
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет элементы [first, last): хвост сдвигается одним проходом
+    // (memmove для тривиально перемещаемых типов), после чего освободившиеся
+    // элементы в конце разрушаются. Сложность O(size - index)
+    iterator Erase(const_iterator first, const_iterator last)
+    {
+        assert(first >= begin() && first <= last && last <= end());
+
+        // Вычисляем индекс первого удаляемого элемента и количество удаляемых
+        const size_t index = std::distance(cbegin(), first);
+        const size_t count = std::distance(first, last);
+        if (count == 0)
+        {
             return begin() + index;
         }
+
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            // Разрушаем удаляемые элементы и сдвигаем хвост одним memmove
+            std::destroy_n(data_ + index, count);
+            std::memmove(static_cast<void*>(data_ + index), static_cast<const void*>(data_ + index + count),
+                         (size_ - index - count) * sizeof(T));
+        }
+        else
+        {
+            iterator new_end = std::move(begin() + index + count, end(), begin() + index);
+            std::destroy(new_end, end());
+        }
+        size_ -= count;
+        MaybeShrink();
+        return begin() + index;
     }
 
-    iterator Insert(const_iterator pos, const T& value)
+    VECTOR_CONSTEXPR size_t Size() const noexcept
     {
-        return Emplace(pos, value);
+        return size_;
     }
 
-    iterator Insert(const_iterator pos, T&& value)
+    VECTOR_CONSTEXPR size_t Capacity() const noexcept
     {
-        return Emplace(pos, std::move(value));
+        return data_.Capacity();
     }
 
-    iterator Erase(const_iterator pos)   /*noexcept(std::is_nothrow_move_assignable_v<T>)*/
+    /*
+    Указатель на первый элемент. В отличие от &v[0], его можно получать и у пустого
+    вектора: тогда он равен nullptr либо указывает на выделенный, но пустой буфер.
+    Итераторы Vector — обычные указатели, поэтому в C++20 Vector является
+    std::ranges::contiguous_range и sized_range, а std::span и std::ranges
+    работают с его буфером напрямую.
+    */
+    VECTOR_CONSTEXPR T* Data() noexcept
     {
-        assert(pos >= begin() && pos <= end());
-        
-        // Вычисляем индекс вставляемого элемента в массиве
-        size_t index = std::distance(cbegin(), pos);
+        return data_.GetAddress();
+    }
 
-        std::move(begin() + index + 1, end(), begin() + index);
-        PopBack();
-        return begin() + index;
+    VECTOR_CONSTEXPR const T* Data() const noexcept
+    {
+        return data_.GetAddress();
     }
 
-    size_t Size() const noexcept
+#if defined(__cpp_lib_span)
+    std::span<T> AsSpan() noexcept
     {
-        return size_;
+        return std::span<T>(Data(), size_);
     }
 
-    size_t Capacity() const noexcept
+    std::span<const T> AsSpan() const noexcept
     {
-        return data_.Capacity();
+        return std::span<const T>(Data(), size_);
+    }
+
+    // Байтовое представление элементов, например, для writev или сериализации
+    std::span<const std::byte> AsBytes() const noexcept
+    {
+        return std::as_bytes(AsSpan());
     }
 
+    std::span<std::byte> AsWritableBytes() noexcept
+    {
+        return std::as_writable_bytes(AsSpan());
+    }
+#endif
+
     /*
     В константном операторе [] используется оператор const_cast, чтобы снять 
     константность с ссылки на текущий объект и вызвать неконстантную версию 
     оператора []. Так получится избавиться от дублирования проверки assert(index < size).
     */
-    const T& operator[](size_t index) const noexcept
+    VECTOR_CONSTEXPR const T& operator[](size_t index) const noexcept
     {
         return const_cast<Vector&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept
+    VECTOR_CONSTEXPR T& operator[](size_t index) noexcept
     {
         assert(index < size_);
         return data_[index];
     }
 
-    void Swap(Vector& other) noexcept
+    // Если propagate_on_container_swap ложно, аллокаторы векторов должны быть
+    // равны, иначе поведение не определено (как и у стандартных контейнеров)
+    VECTOR_CONSTEXPR void Swap(Vector& other) noexcept
     {
+        if constexpr (!AllocTraits::propagate_on_container_swap::value)
+        {
+            assert(data_.GetAllocator() == other.data_.GetAllocator());
+        }
         data_.Swap(other.data_);
         std::swap(size_, other.size_);
     }
 
+    VECTOR_CONSTEXPR Alloc GetAllocator() const noexcept
+    {
+        return data_.GetAllocator();
+    }
+
+    /*
+    Release и Adopt передают буфер без копирования, например от сетевого слоя
+    к парсеру и далее в кэш.
+    Release оставляет вектор пустым, а владение элементами и памятью переходит к
+    вызывающему: он должен разрушить size элементов и освободить память на capacity
+    элементов аллокатором, равным GetAllocator(), либо передать буфер в Adopt.
+    Adopt разрушает текущие элементы, освобождает текущий буфер и становится
+    владельцем буфера data, выделенного аллокатором, равным GetAllocator(),
+    первые size ячеек которого содержат созданные элементы.
+    */
+    [[nodiscard]] VectorBuffer<T> Release() noexcept
+    {
+        VectorBuffer<T> buffer{ nullptr, std::exchange(size_, 0), data_.Capacity() };
+        buffer.data = data_.Release();
+        return buffer;
+    }
 
-    void Reserve(size_t new_capacity)
+    void Adopt(T* data, size_t size, size_t capacity) noexcept
+    {
+        assert(size <= capacity);
+        std::destroy_n(data_.GetAddress(), size_);
+        data_.Adopt(data, capacity);
+        size_ = size;
+    }
+
+    void Adopt(VectorBuffer<T> buffer) noexcept
+    {
+        Adopt(buffer.data, buffer.size, buffer.capacity);
+    }
+
+
+    VECTOR_CONSTEXPR void Reserve(size_t new_capacity)
     {
         if (new_capacity <= data_.Capacity())
         {
             return;
         }
-        RawMemory<T> new_data(new_capacity);
+        if (GrowWithoutCopy(new_capacity))
+        {
+            return;
+        }
+        RawMemory<T, Alloc> new_data(new_capacity, data_.GetAllocator());
+
+        // Переносим элементы в новый буфер (memcpy для тривиально перемещаемых типов)
+        RelocateConstructN(data_.GetAddress(), size_, new_data.GetAddress());
 
-        // Есть ли у типа noexcept-конструктор перемещения ИЛИ отсутствует копирующий конструктор (т.е. есть move-конструктор)
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+        // Удаляем элементы старого вектора
+        DestroyRelocatedN(data_.GetAddress(), size_);
+        VectorStatsRecorder<T>::OnGrowth();
+        // Обмениваемся указателями на буфер
+        data_.Swap(new_data);
+    }
+
+    // То же, что Reserve, но при нехватке памяти, в том числе при исчерпании бюджета
+    // AccountingAllocator, возвращает false и не меняет вектор. Если аллокатор
+    // умеет try_allocate, неудача обходится без исключений. Исключения конструкторов
+    // элементов при переносе в новый буфер передаются вызывающему, как в Reserve
+    bool TryReserve(size_t new_capacity)
+    {
+        if (new_capacity <= data_.Capacity() || data_.TryExpand(new_capacity))
         {
-            // Используем перемещение из старого вектора
-            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
+            return true;
         }
-        else
+        if constexpr (RawMemory<T, Alloc>::CAN_REALLOCATE)
+        {
+            try
+            {
+                data_.Reallocate(new_capacity);
+            }
+            catch (const std::bad_alloc&)
+            {
+                return false;
+            }
+            return true;
+        }
+        if (new_capacity > AllocTraits::max_size(data_.GetAllocator()))
         {
-            // Тип неперемещаем. Используем копирующий конструктор
-            std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
+            return false;
         }
+        RawMemory<T, Alloc> new_data(data_.GetAllocator());
+        if (!new_data.TryAllocate(new_capacity))
+        {
+            return false;
+        }
+        RelocateConstructN(data_.GetAddress(), size_, new_data.GetAddress());
+        DestroyRelocatedN(data_.GetAddress(), size_);
+        VectorStatsRecorder<T>::OnGrowth();
+        data_.Swap(new_data);
+        return true;
+    }
 
-        // Удаляем элементы старого вектора
-        std::destroy_n(data_.GetAddress(), size_);
-        // Обмениваемся указателями на буфер
+    // Память, которую занимает буфер вектора, в байтах
+    VECTOR_CONSTEXPR size_t MemoryUsage() const noexcept
+    {
+        return data_.Capacity() * sizeof(T);
+    }
+
+    // Уменьшает вместимость до размера вектора. Элементы переносятся по тем же
+    // правилам, что и в Reserve, с той же гарантией безопасности исключений
+    VECTOR_CONSTEXPR void ShrinkToFit()
+    {
+        if (size_ == data_.Capacity())
+        {
+            return;
+        }
+        ShrinkTo(size_);
+    }
+
+    /*
+    Вставка в конец через курсор по зарезервированной памяти. Конструктор резервирует
+    место под count элементов, EmplaceBack и PushBack создают элементы без проверок
+    вместимости (их не больше count, проверяется только assert), а деструктор
+    фиксирует новый размер вектора. Циклы заполнения через BackInserter сводятся к
+    последовательным записям в память и поддаются автовекторизации.
+    Пока BackInserter существует, вектор нельзя использовать. Если создание элемента
+    выбросит исключение, созданные ранее элементы остаются в векторе.
+
+        auto inserter = v.ReserveBack(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            inserter.PushBack(Decode(i));
+        }
+    */
+    class BackInserter
+    {
+    public:
+        BackInserter(Vector& vector, size_t count)
+            : vector_(vector)
+        {
+            vector_.Reserve(vector_.size_ + count);
+            cursor_ = vector_.data_ + vector_.size_;
+            limit_ = cursor_ + count;
+        }
+
+        BackInserter(const BackInserter&) = delete;
+        BackInserter& operator=(const BackInserter&) = delete;
+
+        ~BackInserter()
+        {
+            vector_.size_ = static_cast<size_t>(cursor_ - vector_.data_.GetAddress());
+        }
+
+        template <class... Args>
+        T& EmplaceBack(Args&&... args)
+        {
+            assert(cursor_ < limit_);
+            T* element = new(cursor_) T(std::forward<Args>(args)...);
+            ++cursor_;
+            return *element;
+        }
+
+        void PushBack(const T& value)
+        {
+            EmplaceBack(value);
+        }
+
+        void PushBack(T&& value)
+        {
+            EmplaceBack(std::move(value));
+        }
+
+        // Сколько элементов ещё можно вставить
+        size_t Remaining() const noexcept
+        {
+            return static_cast<size_t>(limit_ - cursor_);
+        }
+
+    private:
+        Vector& vector_;
+        T* cursor_;
+        T* limit_;
+    };
+
+    // Резервирует место под count элементов в конце и возвращает BackInserter для их вставки
+    [[nodiscard]] BackInserter ReserveBack(size_t count)
+    {
+        return BackInserter(*this, count);
+    }
+
+protected:
+    // Переносит элементы в новый буфер вместимостью new_capacity >= size_.
+    // Доступна наследникам, которым нужна вместимость больше размера (см. SmallVector)
+    VECTOR_CONSTEXPR void ShrinkTo(size_t new_capacity)
+    {
+        assert(new_capacity >= size_ && new_capacity < data_.Capacity());
+        RawMemory<T, Alloc> new_data(new_capacity, data_.GetAllocator());
+        RelocateConstructN(data_.GetAddress(), size_, new_data.GetAddress());
+        DestroyRelocatedN(data_.GetAddress(), size_);
+        VectorStatsRecorder<T>::OnShrink();
         data_.Swap(new_data);
     }
 
 private:
-    RawMemory<T> data_;
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    RawMemory<T, Alloc> data_;
     size_t size_ = 0;
 
+    // Автоматически освобождает лишнюю память, если политика роста это предусматривает
+    // (см. ShrinkingGrowth). Уменьшение вместимости — лишь оптимизация, поэтому
+    // при нехватке памяти или исключении при копировании буфер остаётся прежним
+    VECTOR_CONSTEXPR void MaybeShrink() noexcept
+    {
+        if constexpr (growth_policy_can_shrink<GrowthPolicy, T, Alloc>::value)
+        {
+            const size_t new_capacity = GrowthPolicy::template ShrinkCapacity<T, Alloc>(data_.Capacity(), size_);
+            if (new_capacity < data_.Capacity())
+            {
+                try
+                {
+                    ShrinkTo(new_capacity);
+                }
+                catch (...)
+                {
+                }
+            }
+        }
+    }
+
+    // Увеличивает вместимость до new_capacity без второго буфера: расширением на месте,
+    // которое не перемещает элементы, или операцией Reallocate для тривиально перемещаемых T,
+    // которая переносит их побайтово. Возвращает false, если аллокатор не умеет ни того, ни другого
+    VECTOR_CONSTEXPR bool GrowWithoutCopy(size_t new_capacity)
+    {
+        if (data_.TryExpand(new_capacity))
+        {
+            return true;
+        }
+        if constexpr (RawMemory<T, Alloc>::CAN_REALLOCATE)
+        {
+            data_.Reallocate(new_capacity);
+            return true;
+        }
+        return false;
+    }
+
+    // Вместимость, до которой растёт вектор, когда ему требуется required_size элементов
+    VECTOR_CONSTEXPR size_t NextCapacity(size_t required_size) const noexcept
+    {
+        return GrowthPolicy::template NextCapacity<T, Alloc>(Capacity(), required_size);
+    }
+
+    // Вставляет count элементов в позицию index. Функция construct(dest) создаёт все
+    // count элементов в неинициализированной памяти dest; при исключении она сама
+    // удаляет уже созданные (как uninitialized-алгоритмы)
+    template <typename Constructor>
+    iterator InsertN(size_t index, size_t count, Constructor construct)
+    {
+        if (count == 0)
+        {
+            return begin() + index;
+        }
+        if (size_ + count > Capacity() && !data_.TryExpand(NextCapacity(size_ + count)))
+        {
+            if constexpr (RawMemory<T, Alloc>::CAN_REALLOCATE)
+            {
+                data_.Reallocate(NextCapacity(size_ + count));
+            }
+            else
+            {
+                InsertNReallocating(index, count, construct);
+                return begin() + index;
+            }
+        }
+
+        T* pos = data_ + index;
+        const size_t tail_size = size_ - index;
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            // Сдвигаем хвост одним memmove. При исключении возвращаем его на место
+            std::memmove(static_cast<void*>(pos + count), static_cast<const void*>(pos), tail_size * sizeof(T));
+            try
+            {
+                construct(pos);
+            }
+            catch (...)
+            {
+                std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + count), tail_size * sizeof(T));
+                throw;
+            }
+        }
+        else
+        {
+            // Создаём новые элементы в свободной памяти за концом вектора (при исключении
+            // вектор не меняется), а затем переставляем их на место одним поворотом
+            construct(data_ + size_);
+            std::rotate(pos, data_ + size_, data_ + size_ + count);
+        }
+        size_ += count;
+        return begin() + index;
+    }
+
+    // Можно ли сдвинуть хвост на одну ячейку и вернуть его обратно без исключений
+    static constexpr bool CAN_SHIFT_NOEXCEPT = is_trivially_relocatable_v<T>
+        || (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>);
+
+    // Указатель на элементы типа T: такой источник копируется как непрерывный массив T
+    template <typename It>
+    static constexpr bool IS_POINTER_TO_T = std::is_pointer_v<It>
+        && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<It>>, T>;
+
+    /*
+    Общая часть копирующего присваивания и Assign: заменяет элементы копиями
+    count элементов, начиная с first.
+    Если вместимости не хватает, буфер сначала расширяется без второго буфера
+    (GrowWithoutCopy), как в Reserve. Если аллокатор этого не умеет, элементы копируются
+    в буфер ровно из count элементов, выделенный один раз, без временного Vector;
+    при исключении вектор не меняется.
+    Иначе буфер переиспользуется: общая часть присваивается, недостающие элементы
+    создаются, лишние разрушаются (базовая гарантия). Тривиально копируемые T
+    из непрерывного источника копируются одним memcpy.
+    */
+    template <typename ForwardIt>
+    VECTOR_CONSTEXPR void AssignCopies(ForwardIt first, size_t count)
+    {
+        if (data_.Capacity() < count && !GrowWithoutCopy(count))
+        {
+            RawMemory<T, Alloc> new_data(count, data_.GetAllocator());
+            CopyConstructN(first, count, new_data.GetAddress());
+            std::destroy_n(data_.GetAddress(), size_);
+            data_.Swap(new_data);
+            size_ = count;
+            return;
+        }
+        if constexpr (std::is_trivially_copyable_v<T> && IS_POINTER_TO_T<ForwardIt>)
+        {
+            // Для таких T присваивание и создание копии — одно и то же копирование байтов,
+            // а разрушение лишних элементов ничего не делает
+            if (!VectorIsConstantEvaluated())
+            {
+                if (count != 0)
+                {
+                    std::memcpy(data_.GetAddress(), first, count * sizeof(T));
+                }
+                size_ = count;
+                return;
+            }
+        }
+        if (size_ > count)
+        {
+            std::copy_n(first, count, data_.GetAddress());
+            std::destroy_n(data_.GetAddress() + count, size_ - count);
+        }
+        else
+        {
+            ForwardIt middle = first;
+            std::advance(middle, size_);
+            std::copy(first, middle, data_.GetAddress());
+            CopyConstructN(middle, count - size_, data_.GetAddress() + size_);
+        }
+        size_ = count;
+    }
+
+    template <typename ForwardIt>
+    static VECTOR_CONSTEXPR void CopyConstructN(ForwardIt first, size_t count, T* dest)
+    {
+        if constexpr (IS_POINTER_TO_T<ForwardIt>)
+        {
+            VectorUninitialized<T>::CopyN(first, count, dest);
+        }
+        else
+        {
+            std::uninitialized_copy_n(first, count, dest);
+        }
+    }
+
+    // Находится ли объект по адресу ptr внутри элементов вектора (в том числе является их частью)
+    bool IsInsideElements(const void* ptr) const noexcept
+    {
+        const std::less<const void*> less;
+        return !less(ptr, data_.GetAddress()) && less(ptr, data_.GetAddress() + size_);
+    }
+
+    // Аргументы, которые не владеют ресурсами: сдвиг хвоста может изменить их,
+    // только если они сами находятся внутри сдвигаемых элементов
+    template <typename U>
+    static constexpr bool IS_SCALAR_ARG = std::is_arithmetic_v<std::decay_t<U>> || std::is_enum_v<std::decay_t<U>>;
+
+    /*
+    Вставляет элемент в позицию index < size_, когда в буфере есть место.
+    Элемент создаётся сразу в освобождённой сдвигом ячейке, без временного объекта, если
+    аргументов нет, все они числа или перечисления вне элементов вектора (они передаются
+    конструктору по ссылке, как есть), либо аргумент один и это T. Если такой аргумент —
+    элемент самого вектора (Insert(pos, v[i])), после сдвига он берётся с нового места.
+    Прочие аргументы могут ссылаться на элементы или их ресурсы, поэтому для них, как и для
+    типов, чей хвост нельзя сдвинуть без исключений, элемент сначала создаётся во временном объекте.
+    */
+    template <typename... Args>
+    void EmplaceInCapacity(size_t index, Args&&... args)
+    {
+        if constexpr (CAN_SHIFT_NOEXCEPT && sizeof...(Args) == 1
+                      && (std::is_same_v<std::decay_t<Args>, T> && ...))
+        {
+            EmplaceShiftedElement(index, std::forward<Args>(args)...);
+        }
+        else
+        {
+            if constexpr (CAN_SHIFT_NOEXCEPT && (IS_SCALAR_ARG<Args> && ...))
+            {
+                if (!(IsInsideElements(std::addressof(args)) || ...))
+                {
+                    ShiftTailRight(index);
+                    ConstructInGap(index, std::forward<Args>(args)...);
+                    return;
+                }
+            }
+            T inserting_value_tmp = T(std::forward<Args>(args)...);
+            if constexpr (is_trivially_relocatable_v<T>)
+            {
+                ShiftTailRight(index);
+                ConstructInGap(index, std::move(inserting_value_tmp));
+            }
+            else
+            {
+                new(data_ + size_) T(std::move(data_[size_ - 1]));
+                std::move_backward(begin() + index, begin() + size_ - 1, begin() + size_);
+                data_[index] = std::move(inserting_value_tmp);
+                ++size_;
+            }
+        }
+    }
+
+    // Вставляет копию (или перемещённое значение) value. Если value — элемент вектора,
+    // после сдвига хвоста он берётся с нового места
+    template <typename U>
+    void EmplaceShiftedElement(size_t index, U&& value)
+    {
+        if (!IsInsideElements(std::addressof(value)))
+        {
+            ShiftTailRight(index);
+            ConstructInGap(index, std::forward<U>(value));
+            return;
+        }
+        const size_t source_index = static_cast<size_t>(std::addressof(value) - data_.GetAddress());
+        ShiftTailRight(index);
+        T& source = data_[source_index >= index ? source_index + 1 : source_index];
+        ConstructInGap(index, static_cast<U&&>(source));
+    }
+
+    // Сдвигает элементы [index, size_) на одну ячейку вправо. Ячейка index остаётся без объекта
+    void ShiftTailRight(size_t index) noexcept
+    {
+        static_assert(CAN_SHIFT_NOEXCEPT);
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            std::memmove(static_cast<void*>(data_ + index + 1), static_cast<const void*>(data_ + index),
+                         (size_ - index) * sizeof(T));
+        }
+        else
+        {
+            new(data_ + size_) T(std::move(data_[size_ - 1]));
+            std::move_backward(begin() + index, begin() + size_ - 1, begin() + size_);
+            std::destroy_at(data_ + index);
+        }
+    }
+
+    // Отменяет ShiftTailRight: возвращает хвост на место, заполняя ячейку index
+    void CloseGap(size_t index) noexcept
+    {
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            std::memmove(static_cast<void*>(data_ + index), static_cast<const void*>(data_ + index + 1),
+                         (size_ - index) * sizeof(T));
+        }
+        else
+        {
+            new(data_ + index) T(std::move(data_[index + 1]));
+            std::move(begin() + index + 2, begin() + size_ + 1, begin() + index + 1);
+            std::destroy_at(data_ + size_);
+        }
+    }
+
+    // Создаёт элемент в ячейке, освобождённой ShiftTailRight. При исключении
+    // хвост возвращается на место, и вектор не меняется
+    template <typename... Args>
+    void ConstructInGap(size_t index, Args&&... args)
+    {
+        try
+        {
+            new(data_ + index) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            CloseGap(index);
+            throw;
+        }
+        ++size_;
+    }
+
+    // Реаллоцирующая ветка InsertN: новые элементы создаются сразу в новом буфере,
+    // а старые переносятся вокруг них так же, как в Emplace
+    template <typename Constructor>
+    void InsertNReallocating(size_t index, size_t count, Constructor& construct)
+    {
+        RawMemory<T, Alloc> new_data(NextCapacity(size_ + count), data_.GetAllocator());
+        construct(new_data.GetAddress() + index);
+        try
+        {
+            RelocateConstructN(data_.GetAddress(), index, new_data.GetAddress());
+        }
+        catch (...)
+        {
+            std::destroy_n(new_data.GetAddress() + index, count);
+            throw;
+        }
+        try
+        {
+            RelocateConstructN(data_.GetAddress() + index, size_ - index, new_data.GetAddress() + index + count);
+        }
+        catch (...)
+        {
+            std::destroy_n(new_data.GetAddress(), index + count);
+            throw;
+        }
+        data_.Swap(new_data);
+        DestroyRelocatedN(new_data.GetAddress(), size_);
+        VectorStatsRecorder<T>::OnGrowth();
+        size_ += count;
+    }
+
+    /*
+    Медленный путь всех вставок одного элемента (EmplaceBack, PushBack, Emplace, Insert):
+    буфер заполнен. Сначала пробует расширить буфер на месте, иначе выделяет новый
+    и переносит в него элементы. Общий для всех методов и не встраивается, поэтому
+    код реаллокации существует в одном экземпляре на набор аргументов, а быстрые пути
+    остаются короткими. Аргументы могут ссылаться на элементы самого вектора, поэтому
+    новый элемент создаётся до переноса старых. AT_BACK означает вставку в конец (index == size_),
+    тогда сдвиг хвоста не инстанцируется и T не обязан поддерживать присваивание.
+    Возвращает ссылку на вставленный элемент
+    */
+    template <bool AT_BACK, typename... Args>
+    VECTOR_NOINLINE_COLD VECTOR_CONSTEXPR T& EmplaceGrowing(size_t index, Args&&... args)
+    {
+        assert(AT_BACK == (index == size_));
+        const size_t new_capacity = NextCapacity(size_ + 1);
+        if (data_.TryExpand(new_capacity))
+        {
+            if constexpr (AT_BACK)
+            {
+                VectorUninitialized<T>::ConstructAt(data_ + size_, std::forward<Args>(args)...);
+                ++size_;
+            }
+            else
+            {
+                EmplaceInCapacity(index, std::forward<Args>(args)...);
+            }
+            return data_[index];
+        }
+        if constexpr (RawMemory<T, Alloc>::CAN_REALLOCATE)
+        {
+            return EmplaceReallocating(index, new_capacity, std::forward<Args>(args)...);
+        }
+        else
+        {
+            RawMemory<T, Alloc> new_data(new_capacity, data_.GetAllocator());
+
+            // 1. Создаём новый элемент в позиции index нового буфера
+            VectorUninitialized<T>::ConstructAt(new_data.GetAddress() + index, std::forward<Args>(args)...);
+
+            // 2. Переносим элементы, предшествующие вставляемому.
+            //    В случае исключений подчищать нужно вручную, старый буфер остаётся нетронутым
+            try
+            {
+                RelocateConstructN(data_.GetAddress(), index, new_data.GetAddress());
+            }
+            catch (...)
+            {
+                // Перенос не получился. Удаляем элемент из шага 1
+                std::destroy_at(new_data.GetAddress() + index);
+                throw;
+            }
+
+            // 3. Переносим элементы, следующие за вставляемым
+            try
+            {
+                RelocateConstructN(data_.GetAddress() + index, size_ - index, new_data.GetAddress() + index + 1);
+            }
+            catch (...)
+            {
+                // Перенос не получился. Удаляем элементы из шагов 1 и 2.
+                // Для тривиально перемещаемых типов исключений здесь не бывает
+                std::destroy(new_data.GetAddress(), new_data.GetAddress() + index + 1);
+                throw;
+            }
+
+            data_.Swap(new_data);
+            // Вызываем деструкторы у старых элементов
+            DestroyRelocatedN(new_data.GetAddress(), size_);
+            VectorStatsRecorder<T>::OnGrowth();
+            ++size_;
+            return data_[index];
+        }
+    }
+
+    // Вставляет элемент в позицию index, расширяя буфер через RawMemory::Reallocate.
+    // Аргументы могут ссылаться на элементы самого вектора, поэтому элемент сначала
+    // создаётся во временной сырой ячейке, а после расширения переносится в буфер побайтово
+    template <typename... Args>
+    T& EmplaceReallocating(size_t index, size_t new_capacity, Args&&... args)
+    {
+        alignas(T) unsigned char slot[sizeof(T)];
+        T* element = new(slot) T(std::forward<Args>(args)...);
+        try
+        {
+            data_.Reallocate(new_capacity);
+        }
+        catch (...)
+        {
+            std::destroy_at(element);
+            throw;
+        }
+        std::memmove(static_cast<void*>(data_ + index + 1), static_cast<const void*>(data_ + index),
+                     (size_ - index) * sizeof(T));
+        std::memcpy(static_cast<void*>(data_ + index), static_cast<const void*>(slot), sizeof(T));
+        ++size_;
+        return data_[index];
+    }
+
+    // Конструирует в неинициализированной памяти to копии n элементов from:
+    // побайтово для тривиально перемещаемых типов, иначе перемещением, если
+    // move-конструктор noexcept или копирование недоступно, и копированием в остальных случаях.
+    // При исключении уже созданные элементы удаляются, исходные остаются нетронутыми
+    static VECTOR_CONSTEXPR void RelocateConstructN(T* from, size_t n, T* to)
+    {
+        // При константном вычислении memcpy недоступен, и элементы переносятся поштучно
+        if (is_trivially_relocatable_v<T> && !VectorIsConstantEvaluated())
+        {
+            if (n != 0)
+            {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(T));
+            }
+            VectorStatsRecorder<T>::OnRelocated(n);
+        }
+        else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+        {
+            VectorUninitialized<T>::MoveN(from, n, to);
+            VectorStatsRecorder<T>::OnMoved(n);
+        }
+        else
+        {
+            VectorUninitialized<T>::CopyN(from, n, to);
+            VectorStatsRecorder<T>::OnCopied(n);
+        }
+    }
+
+    // Завершает перенос, начатый RelocateConstructN: разрушает исходные элементы.
+    // Тривиально перемещённые элементы уже принадлежат новому буферу и не разрушаются
+    static VECTOR_CONSTEXPR void DestroyRelocatedN(T* from, size_t n) noexcept
+    {
+        if (!is_trivially_relocatable_v<T> || VectorIsConstantEvaluated())
+        {
+            std::destroy_n(from, n);
+        }
+    }
+
     // Вызывает деструкторы n объектов массива по адресу buf
     static void DestroyN(T* buf, size_t n) noexcept
     {
@@ -620,3 +1934,24 @@ private:
         buf->~T();
     }
 };
+
+// Удаляет из вектора все элементы, удовлетворяющие предикату, за один проход
+// и возвращает количество удалённых элементов (аналог std::erase_if)
+template <typename T, typename Alloc, typename GrowthPolicy, typename Predicate>
+size_t EraseIf(Vector<T, Alloc, GrowthPolicy>& v, Predicate pred)
+{
+    auto new_end = std::remove_if(v.begin(), v.end(), pred);
+    const size_t removed = std::distance(new_end, v.end());
+    v.Erase(new_end, v.end());
+    return removed;
+}
+
+// Удаляет из вектора все элементы, равные value (аналог std::erase)
+template <typename T, typename Alloc, typename GrowthPolicy, typename U>
+size_t Erase(Vector<T, Alloc, GrowthPolicy>& v, const U& value)
+{
+    return EraseIf(v, [&value](const T& elem)
+                   {
+                       return elem == value;
+                   });
+}
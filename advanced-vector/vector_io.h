@@ -0,0 +1,234 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <system_error>
+
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+/*
+Двоичная запись и чтение Vector<T> для тривиально копируемых T.
+
+Формат: заголовок VectorFileHeader (сигнатура, версия формата, размер элемента,
+количество элементов и контрольная сумма данных), за которым следуют байты
+элементов. Числа записываются в порядке байтов текущей платформы.
+
+WriteTo записывает заголовок и данные одной операцией writev (или двумя write
+в поток). ReadFrom читает данные прямо в буфер вектора, созданный
+ResizeDefaultInit, поэтому элементы не инициализируются перед загрузкой.
+ReadFrom даёт строгую гарантию: при ошибке вектор не меняется.
+
+ReadFrom из дескриптора делает два чтения, а не одно readv: размер буфера под
+данные известен только из заголовка. Одно readv пришлось бы выполнить в буфер
+угаданного размера, а лишние байты, прочитанные из канала или сокета за концом
+вектора, вернуть в дескриптор нельзя. Второе чтение идёт сразу в буфер вектора,
+так что данные всё равно не копируются, а лишний системный вызов на заголовок
+не заметен на фоне чтения данных.
+
+Ошибки ввода-вывода сообщаются исключением std::system_error (для дескрипторов)
+или std::runtime_error (для потоков), несовместимый или повреждённый заголовок,
+неполные данные и несовпадение контрольной суммы — исключением std::runtime_error.
+*/
+
+struct VectorFileHeader
+{
+    static constexpr uint64_t MAGIC = 0x3153554f45564156;  // "VAVEOUS1"
+    static constexpr uint32_t VERSION = 1;
+
+    uint64_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t element_size = 0;
+    uint64_t size = 0;
+    uint64_t checksum = 0;
+};
+
+// Контрольная сумма в духе Флетчера по 32-битным словам: простая сумма и сумма сумм
+// обрабатывают данные со скоростью памяти и замечают как искажение, так и перестановку слов
+inline uint64_t VectorChecksum(const void* data, size_t bytes) noexcept
+{
+    const unsigned char* ptr = static_cast<const unsigned char*>(data);
+    uint64_t sum = 0;
+    uint64_t sum_of_sums = 0;
+    size_t i = 0;
+    for (; i + sizeof(uint32_t) <= bytes; i += sizeof(uint32_t))
+    {
+        uint32_t word;
+        std::memcpy(&word, ptr + i, sizeof(word));
+        sum += word;
+        sum_of_sums += sum;
+    }
+    for (; i < bytes; ++i)
+    {
+        sum += ptr[i];
+        sum_of_sums += sum;
+    }
+    return sum ^ (sum_of_sums << 32) ^ (sum_of_sums >> 32) ^ bytes;
+}
+
+// Вспомогательные функции WriteTo и ReadFrom
+
+template <typename T>
+VectorFileHeader MakeVectorFileHeader(const T* data, size_t size) noexcept
+{
+    VectorFileHeader header;
+    header.element_size = sizeof(T);
+    header.size = size;
+    header.checksum = VectorChecksum(data, size * sizeof(T));
+    return header;
+}
+
+template <typename T>
+size_t CheckVectorFileHeader(const VectorFileHeader& header)
+{
+    if (header.magic != VectorFileHeader::MAGIC || header.version != VectorFileHeader::VERSION)
+    {
+        throw std::runtime_error("ReadFrom: not a vector file or unsupported version");
+    }
+    if (header.element_size != sizeof(T))
+    {
+        throw std::runtime_error("ReadFrom: element size mismatch");
+    }
+    if (header.size > static_cast<size_t>(-1) / sizeof(T))
+    {
+        throw std::runtime_error("ReadFrom: corrupted header");
+    }
+    return static_cast<size_t>(header.size);
+}
+
+template <typename T>
+void CheckVectorFileData(const VectorFileHeader& header, const T* data)
+{
+    if (VectorChecksum(data, static_cast<size_t>(header.size) * sizeof(T)) != header.checksum)
+    {
+        throw std::runtime_error("ReadFrom: checksum mismatch");
+    }
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+// Записывает все буферы, повторяя writev после частичной записи и прерывания сигналом
+inline void WriteAllToFd(int fd, iovec* iov, int count)
+{
+    while (count > 0)
+    {
+        const ssize_t written = ::writev(fd, iov, count);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "writev");
+        }
+        size_t remaining = static_cast<size_t>(written);
+        while (count > 0 && remaining >= iov->iov_len)
+        {
+            remaining -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0)
+        {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+            iov->iov_len -= remaining;
+        }
+    }
+}
+
+inline void ReadAllFromFd(int fd, void* data, size_t bytes)
+{
+    char* ptr = static_cast<char*>(data);
+    while (bytes > 0)
+    {
+        const ssize_t count = ::read(fd, ptr, bytes);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "read");
+        }
+        if (count == 0)
+        {
+            throw std::runtime_error("ReadFrom: unexpected end of file");
+        }
+        ptr += count;
+        bytes -= static_cast<size_t>(count);
+    }
+}
+#endif
+
+template <typename T, typename Alloc, typename GrowthPolicy>
+void WriteTo(const Vector<T, Alloc, GrowthPolicy>& v, std::ostream& output)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "WriteTo requires trivially copyable T");
+    const VectorFileHeader header = MakeVectorFileHeader(v.Data(), v.Size());
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(v.Data()), static_cast<std::streamsize>(v.Size() * sizeof(T)));
+    if (!output)
+    {
+        throw std::runtime_error("WriteTo: stream write failed");
+    }
+}
+
+template <typename T, typename Alloc, typename GrowthPolicy>
+void ReadFrom(Vector<T, Alloc, GrowthPolicy>& v, std::istream& input)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "ReadFrom requires trivially copyable T");
+    VectorFileHeader header;
+    input.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!input)
+    {
+        throw std::runtime_error("ReadFrom: cannot read header");
+    }
+    Vector<T, Alloc, GrowthPolicy> result(v.GetAllocator());
+    result.ResizeDefaultInit(CheckVectorFileHeader<T>(header));
+    input.read(reinterpret_cast<char*>(result.Data()), static_cast<std::streamsize>(result.Size() * sizeof(T)));
+    if (!input)
+    {
+        throw std::runtime_error("ReadFrom: unexpected end of stream");
+    }
+    CheckVectorFileData(header, result.Data());
+    v = std::move(result);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+template <typename T, typename Alloc, typename GrowthPolicy>
+void WriteTo(const Vector<T, Alloc, GrowthPolicy>& v, int fd)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "WriteTo requires trivially copyable T");
+    VectorFileHeader header = MakeVectorFileHeader(v.Data(), v.Size());
+    iovec iov[2] = {
+        { &header, sizeof(header) },
+        { const_cast<T*>(v.Data()), v.Size() * sizeof(T) },
+    };
+    WriteAllToFd(fd, iov, v.Size() != 0 ? 2 : 1);
+}
+
+template <typename T, typename Alloc, typename GrowthPolicy>
+void ReadFrom(Vector<T, Alloc, GrowthPolicy>& v, int fd)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "ReadFrom requires trivially copyable T");
+    // Заголовок читается отдельно: без него неизвестен размер данных (см. описание выше)
+    VectorFileHeader header;
+    ReadAllFromFd(fd, &header, sizeof(header));
+    Vector<T, Alloc, GrowthPolicy> result(v.GetAllocator());
+    result.ResizeDefaultInit(CheckVectorFileHeader<T>(header));
+    ReadAllFromFd(fd, result.Data(), result.Size() * sizeof(T));
+    CheckVectorFileData(header, result.Data());
+    v = std::move(result);
+}
+#endif
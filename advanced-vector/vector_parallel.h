@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+#if defined(VECTOR_ENABLE_PARALLEL)
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+#endif
+
+/*
+Необязательное параллельное копирование и перенос элементов Vector.
+
+Включается макросом VECTOR_ENABLE_PARALLEL, который нужно определить до подключения
+vector.h (или передать компилятору: -DVECTOR_ENABLE_PARALLEL). Тогда конструктор
+копирования, копирующее присваивание и реаллокации (Reserve, рост при вставке)
+создают элементы нетривиальных типов в нескольких потоках, если их не меньше
+VECTOR_PARALLEL_THRESHOLD. Тривиально копируемые типы по-прежнему копируются
+одним memcpy, а без макроса всё выполняется в вызывающем потоке.
+
+Диапазон делится на равные части по числу аппаратных потоков, первая часть
+обрабатывается вызывающим потоком. Если создание элемента в какой-либо части
+выбросит исключение, элементы, уже созданные в остальных частях, разрушаются,
+и исключение передаётся вызывающему, так что Vector сохраняет строгую гарантию.
+Если поток запустить не удалось, его часть выполняется в вызывающем потоке.
+Число потоков можно ограничить макросом VECTOR_PARALLEL_THREADS (0 — по числу ядер).
+
+Предусловие: конструкторы копирования и перемещения T (и деструктор при откате)
+для разных элементов должны быть безопасны при одновременном вызове из нескольких
+потоков. Типы, которые меняют общее состояние без синхронизации (неатомарные
+статические счётчики, общий кэш, разделяемый буфер без атомарного счётчика ссылок),
+с VECTOR_ENABLE_PARALLEL использовать нельзя.
+*/
+
+#if !defined(VECTOR_PARALLEL_THRESHOLD)
+#define VECTOR_PARALLEL_THRESHOLD (size_t{ 1 } << 16)
+#endif
+
+#if !defined(VECTOR_PARALLEL_THREADS)
+#define VECTOR_PARALLEL_THREADS 0
+#endif
+
+template <typename T>
+struct VectorParallel
+{
+    // Копирует n элементов from в неинициализированную память to
+    static void UninitializedCopyN(const T* from, size_t n, T* to)
+    {
+#if defined(VECTOR_ENABLE_PARALLEL)
+        if (!std::is_trivially_copyable_v<T> && n >= VECTOR_PARALLEL_THRESHOLD)
+        {
+            ForEachPart(n, to, [from, to](size_t begin, size_t count) {
+                std::uninitialized_copy_n(from + begin, count, to + begin);
+            });
+            return;
+        }
+#endif
+        std::uninitialized_copy_n(from, n, to);
+    }
+
+    // Перемещает n элементов from в неинициализированную память to
+    static void UninitializedMoveN(T* from, size_t n, T* to)
+    {
+#if defined(VECTOR_ENABLE_PARALLEL)
+        if (!std::is_trivially_copyable_v<T> && n >= VECTOR_PARALLEL_THRESHOLD)
+        {
+            ForEachPart(n, to, [from, to](size_t begin, size_t count) {
+                std::uninitialized_move_n(from + begin, count, to + begin);
+            });
+            return;
+        }
+#endif
+        std::uninitialized_move_n(from, n, to);
+    }
+
+#if defined(VECTOR_ENABLE_PARALLEL)
+private:
+    struct Part
+    {
+        size_t begin = 0;
+        size_t count = 0;
+        std::exception_ptr error;
+    };
+
+    // Вызывает construct(begin, count) для частей [0, n). Каждая часть при исключении
+    // сама удаляет созданные ею элементы, поэтому разрушать нужно только успешные части
+    template <typename Construct>
+    static void ForEachPart(size_t n, T* to, Construct construct)
+    {
+        // Части не короче половины порога, чтобы запуск потока окупался
+        const size_t thread_count = VECTOR_PARALLEL_THREADS != 0 ? VECTOR_PARALLEL_THREADS
+                                                                 : std::thread::hardware_concurrency();
+        const size_t part_count = std::max<size_t>(
+            1, std::min<size_t>(thread_count, n / (VECTOR_PARALLEL_THRESHOLD / 2 + 1) + 1));
+        const size_t part_size = (n + part_count - 1) / part_count;
+
+        // Исключение до запуска потоков безопасно: ни один элемент ещё не создан
+        std::vector<Part> parts(part_count);
+        for (size_t i = 0; i < part_count; ++i)
+        {
+            parts[i].begin = std::min(n, i * part_size);
+            parts[i].count = std::min(n, parts[i].begin + part_size) - parts[i].begin;
+        }
+        std::vector<std::thread> threads;
+        threads.reserve(part_count - 1);
+
+        auto run = [&construct](Part& part) noexcept {
+            try
+            {
+                construct(part.begin, part.count);
+            }
+            catch (...)
+            {
+                part.error = std::current_exception();
+            }
+        };
+        for (size_t i = 1; i < part_count; ++i)
+        {
+            Part& part = parts[i];
+            try
+            {
+                threads.emplace_back([&run, &part] {
+                    run(part);
+                });
+            }
+            catch (...)
+            {
+                run(part);
+            }
+        }
+        run(parts[0]);
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        std::exception_ptr error;
+        for (const Part& part : parts)
+        {
+            if (part.error && !error)
+            {
+                error = part.error;
+            }
+        }
+        if (error)
+        {
+            for (const Part& part : parts)
+            {
+                if (!part.error)
+                {
+                    std::destroy_n(to + part.begin, part.count);
+                }
+            }
+            std::rethrow_exception(error);
+        }
+    }
+#endif
+};
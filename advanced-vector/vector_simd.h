@@ -0,0 +1,495 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+/*
+Векторизованные групповые операции над Vector<T> арифметических типов
+(float, double, целые до 64 бит):
+
+    Fill(v, value)                — заполняет вектор значением;
+    Find(v, value)                — итератор первого элемента, равного value, или end();
+    Accumulate(v, init)           — сумма элементов, начиная с init;
+    Transform(from, to, op)       — to[i] = op(from[i]), to может совпадать с from;
+    CopyConvert(from, to)         — to[i] = static_cast<U>(from[i]).
+
+Ядра написаны на векторных расширениях GCC и Clang (vector_size) и обрабатывают
+по регистру за шаг, в том числе там, где автовекторизатор отказывается: поиск
+с досрочным выходом и сумма float без -ffast-math. На x86-64 ядра собираются
+трижды — для SSE2, AVX2 и AVX-512 — и выбираются во время выполнения по
+возможностям процессора (GetVectorSimdLevel), на AArch64 используются регистры NEON.
+Другие компиляторы и макрос VECTOR_SIMD_DISABLE дают обычные циклы.
+
+Accumulate складывает элементы в нескольких независимых суммах, поэтому для
+float и double результат может отличаться от std::accumulate в младших разрядах.
+Transform вызывает op сразу для 16-байтного регистра, если op его принимает, например,
+обобщённая лямбда [](auto x) { return x * 2 + 1; }; иначе op вызывается для
+каждого элемента. Обобщённая лямбда, тело которой не компилируется для векторного
+типа, вызовет ошибку компиляции — тогда укажите тип параметра явно.
+Выравнивание буфера (AlignedAllocator) ускоряет загрузки, но не требуется.
+*/
+
+#if !defined(VECTOR_SIMD_DISABLE) && (defined(__GNUC__) || defined(__clang__))
+#define VECTOR_SIMD_VECTOR_EXTENSIONS 1
+#if defined(__x86_64__) || defined(__i386__)
+#define VECTOR_SIMD_X86_DISPATCH 1
+#define VECTOR_SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#define VECTOR_SIMD_TARGET_AVX512 __attribute__((target("avx2,avx512f,avx512bw,avx512dq,avx512vl")))
+#endif
+#endif
+
+enum class VectorSimdLevel
+{
+    SCALAR,
+    SSE2,
+    AVX2,
+    AVX512,
+    NEON,
+};
+
+inline VectorSimdLevel DetectVectorSimdLevel() noexcept
+{
+#if defined(VECTOR_SIMD_X86_DISPATCH)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+        && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl"))
+    {
+        return VectorSimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return VectorSimdLevel::AVX2;
+    }
+    return VectorSimdLevel::SSE2;
+#elif defined(VECTOR_SIMD_VECTOR_EXTENSIONS) && defined(__ARM_NEON)
+    return VectorSimdLevel::NEON;
+#else
+    return VectorSimdLevel::SCALAR;
+#endif
+}
+
+// Набор инструкций, который используют ядра. Определяется один раз при первом вызове
+inline VectorSimdLevel GetVectorSimdLevel() noexcept
+{
+    static const VectorSimdLevel level = DetectVectorSimdLevel();
+    return level;
+}
+
+template <typename T>
+inline constexpr bool is_vector_simd_type_v =
+    std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= sizeof(uint64_t);
+
+#if defined(VECTOR_SIMD_VECTOR_EXTENSIONS)
+/*
+Ядра для регистров шириной BYTES байт. Все функции встраиваются в обёртку,
+собранную для нужного набора инструкций, поэтому векторные типы превращаются
+в регистры этого набора. COMPARE_BYTES — ширина сравнений в Find: GCC плохо
+собирает векторные сравнения шириной 64 байта под AVX-512, поэтому там
+сравнения выполняются регистрами по 32 байта.
+*/
+#if defined(__GNUC__) && !defined(__clang__)
+// Ядра всегда встраиваются, поэтому предупреждения о передаче широких регистров их не касаются
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+template <typename T, size_t BYTES, size_t COMPARE_BYTES = BYTES>
+struct VectorSimdKernels
+{
+    typedef T Reg __attribute__((vector_size(BYTES)));
+    static constexpr size_t LANES = BYTES / sizeof(T);
+
+    [[gnu::always_inline]] static Reg Load(const T* from) noexcept
+    {
+        Reg reg;
+        std::memcpy(&reg, from, sizeof(reg));
+        return reg;
+    }
+
+    [[gnu::always_inline]] static void Store(T* to, const Reg& reg) noexcept
+    {
+        std::memcpy(to, &reg, sizeof(reg));
+    }
+
+    [[gnu::always_inline]] static Reg Splat(T value) noexcept
+    {
+        Reg reg;
+        for (size_t i = 0; i < LANES; ++i)
+        {
+            reg[i] = value;
+        }
+        return reg;
+    }
+
+    [[gnu::always_inline]] static void Fill(T* data, size_t n, T value) noexcept
+    {
+        const Reg reg = Splat(value);
+        const size_t vector_end = n - n % LANES;
+        size_t i = 0;
+        for (; i < vector_end; i += LANES)
+        {
+            Store(data + i, reg);
+        }
+        for (; i < n; ++i)
+        {
+            data[i] = value;
+        }
+    }
+
+    // Индекс первого элемента, равного value, или n. Проверяет по четыре регистра
+    // за шаг, а позицию внутри блока с совпадением ищет обычным циклом
+    [[gnu::always_inline]] static size_t Find(const T* data, size_t n, T value) noexcept
+    {
+        using Compare = VectorSimdKernels<T, COMPARE_BYTES>;
+        constexpr size_t STEP = Compare::LANES;
+        constexpr size_t BLOCK = STEP * 4;
+        const typename Compare::Reg needle = Compare::Splat(value);
+        const size_t vector_end = n - n % BLOCK;
+        size_t i = 0;
+        for (; i < vector_end; i += BLOCK)
+        {
+            const auto mask = (Compare::Load(data + i) == needle) | (Compare::Load(data + i + STEP) == needle)
+                | (Compare::Load(data + i + 2 * STEP) == needle) | (Compare::Load(data + i + 3 * STEP) == needle);
+            if (AnyLane(mask))
+            {
+                break;
+            }
+        }
+        for (; i < n; ++i)
+        {
+            if (data[i] == value)
+            {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    [[gnu::always_inline]] static T Accumulate(const T* data, size_t n, T init) noexcept
+    {
+        // Целые складываются без знака: результат тот же, что у std::accumulate
+        // по модулю 2^N, но переполнение регистров со знаком не является UB
+        if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+        {
+            using Unsigned = std::make_unsigned_t<T>;
+            return static_cast<T>(VectorSimdKernels<Unsigned, BYTES>::Accumulate(
+                reinterpret_cast<const Unsigned*>(data), n, static_cast<Unsigned>(init)));
+        }
+        // Две независимые суммы скрывают задержку сложения
+        Reg sum0 = Splat(T{});
+        Reg sum1 = sum0;
+        const size_t vector_end = n - n % (2 * LANES);
+        size_t i = 0;
+        for (; i < vector_end; i += 2 * LANES)
+        {
+            sum0 += Load(data + i);
+            sum1 += Load(data + i + LANES);
+        }
+        sum0 += sum1;
+        T result = init;
+        for (size_t lane = 0; lane < LANES; ++lane)
+        {
+            result += sum0[lane];
+        }
+        for (; i < n; ++i)
+        {
+            result += data[i];
+        }
+        return result;
+    }
+
+    template <typename Op>
+    [[gnu::always_inline]] static void Transform(const T* from, size_t n, T* to, Op& op)
+    {
+        // op собран без атрибутов набора инструкций, поэтому получает 16-байтные
+        // регистры, которые передаются одинаково на всех уровнях. После встраивания
+        // op компилируется с инструкциями обёртки
+        using Chunk = VectorSimdKernels<T, 16>;
+        size_t i = 0;
+        if constexpr (std::is_invocable_r_v<typename Chunk::Reg, Op&, typename Chunk::Reg>)
+        {
+            const size_t vector_end = n - n % Chunk::LANES;
+            for (; i < vector_end; i += Chunk::LANES)
+            {
+                Chunk::Store(to + i, static_cast<typename Chunk::Reg>(op(Chunk::Load(from + i))));
+            }
+        }
+        for (; i < n; ++i)
+        {
+            to[i] = static_cast<T>(op(from[i]));
+        }
+    }
+
+    template <typename U>
+    [[gnu::always_inline]] static void CopyConvert(const T* from, size_t n, U* to) noexcept
+    {
+        typedef U Converted __attribute__((vector_size(LANES * sizeof(U))));
+        const size_t vector_end = n - n % LANES;
+        size_t i = 0;
+        for (; i < vector_end; i += LANES)
+        {
+            const Converted converted = __builtin_convertvector(Load(from + i), Converted);
+            std::memcpy(to + i, &converted, sizeof(converted));
+        }
+        for (; i < n; ++i)
+        {
+            to[i] = static_cast<U>(from[i]);
+        }
+    }
+
+    template <typename Mask>
+    [[gnu::always_inline]] static bool AnyLane(const Mask& mask) noexcept
+    {
+        uint64_t words[sizeof(Mask) / sizeof(uint64_t)];
+        std::memcpy(words, &mask, sizeof(mask));
+        uint64_t any = 0;
+        for (uint64_t word : words)
+        {
+            any |= word;
+        }
+        return any != 0;
+    }
+};
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+/*
+Выбор ядра по набору инструкций. Функции принимают уровень явно (по умолчанию —
+GetVectorSimdLevel()), чтобы можно было проверить и сравнить все реализации.
+Уровень выше поддерживаемого процессором приводит к недопустимой инструкции.
+*/
+template <typename T>
+struct VectorSimd
+{
+    static_assert(is_vector_simd_type_v<T>, "VectorSimd requires an arithmetic type of at most 64 bits");
+
+    static void Fill(T* data, size_t n, T value, VectorSimdLevel level = GetVectorSimdLevel()) noexcept
+    {
+#if defined(VECTOR_SIMD_X86_DISPATCH)
+        if (level == VectorSimdLevel::AVX512)
+        {
+            return FillAvx512(data, n, value);
+        }
+        if (level == VectorSimdLevel::AVX2)
+        {
+            return FillAvx2(data, n, value);
+        }
+#endif
+#if defined(VECTOR_SIMD_VECTOR_EXTENSIONS)
+        if (level != VectorSimdLevel::SCALAR)
+        {
+            return VectorSimdKernels<T, 16>::Fill(data, n, value);
+        }
+#endif
+        static_cast<void>(level);
+        std::fill(data, data + n, value);
+    }
+
+    static size_t Find(const T* data, size_t n, T value, VectorSimdLevel level = GetVectorSimdLevel()) noexcept
+    {
+#if defined(VECTOR_SIMD_X86_DISPATCH)
+        if (level == VectorSimdLevel::AVX512)
+        {
+            return FindAvx512(data, n, value);
+        }
+        if (level == VectorSimdLevel::AVX2)
+        {
+            return FindAvx2(data, n, value);
+        }
+#endif
+#if defined(VECTOR_SIMD_VECTOR_EXTENSIONS)
+        if (level != VectorSimdLevel::SCALAR)
+        {
+            return VectorSimdKernels<T, 16>::Find(data, n, value);
+        }
+#endif
+        static_cast<void>(level);
+        return static_cast<size_t>(std::find(data, data + n, value) - data);
+    }
+
+    static T Accumulate(const T* data, size_t n, T init, VectorSimdLevel level = GetVectorSimdLevel()) noexcept
+    {
+#if defined(VECTOR_SIMD_X86_DISPATCH)
+        if (level == VectorSimdLevel::AVX512)
+        {
+            return AccumulateAvx512(data, n, init);
+        }
+        if (level == VectorSimdLevel::AVX2)
+        {
+            return AccumulateAvx2(data, n, init);
+        }
+#endif
+#if defined(VECTOR_SIMD_VECTOR_EXTENSIONS)
+        if (level != VectorSimdLevel::SCALAR)
+        {
+            return VectorSimdKernels<T, 16>::Accumulate(data, n, init);
+        }
+#endif
+        static_cast<void>(level);
+        return std::accumulate(data, data + n, init);
+    }
+
+    template <typename Op>
+    static void Transform(const T* from, size_t n, T* to, Op op, VectorSimdLevel level = GetVectorSimdLevel())
+    {
+#if defined(VECTOR_SIMD_X86_DISPATCH)
+        if (level == VectorSimdLevel::AVX512)
+        {
+            return TransformAvx512(from, n, to, op);
+        }
+        if (level == VectorSimdLevel::AVX2)
+        {
+            return TransformAvx2(from, n, to, op);
+        }
+#endif
+#if defined(VECTOR_SIMD_VECTOR_EXTENSIONS)
+        if (level != VectorSimdLevel::SCALAR)
+        {
+            return VectorSimdKernels<T, 16>::Transform(from, n, to, op);
+        }
+#endif
+        static_cast<void>(level);
+        for (size_t i = 0; i < n; ++i)
+        {
+            to[i] = static_cast<T>(op(from[i]));
+        }
+    }
+
+    template <typename U>
+    static void CopyConvert(const T* from, size_t n, U* to, VectorSimdLevel level = GetVectorSimdLevel()) noexcept
+    {
+        static_assert(is_vector_simd_type_v<U>, "CopyConvert requires an arithmetic type of at most 64 bits");
+#if defined(VECTOR_SIMD_X86_DISPATCH)
+        if (level == VectorSimdLevel::AVX512)
+        {
+            return CopyConvertAvx512(from, n, to);
+        }
+        if (level == VectorSimdLevel::AVX2)
+        {
+            return CopyConvertAvx2(from, n, to);
+        }
+#endif
+#if defined(VECTOR_SIMD_VECTOR_EXTENSIONS)
+        if (level != VectorSimdLevel::SCALAR)
+        {
+            return VectorSimdKernels<T, 16>::CopyConvert(from, n, to);
+        }
+#endif
+        static_cast<void>(level);
+        for (size_t i = 0; i < n; ++i)
+        {
+            to[i] = static_cast<U>(from[i]);
+        }
+    }
+
+#if defined(VECTOR_SIMD_X86_DISPATCH)
+private:
+    using Avx2 = VectorSimdKernels<T, 32>;
+    using Avx512 = VectorSimdKernels<T, 64, 32>;
+
+    VECTOR_SIMD_TARGET_AVX2 static void FillAvx2(T* data, size_t n, T value) noexcept
+    {
+        Avx2::Fill(data, n, value);
+    }
+
+    VECTOR_SIMD_TARGET_AVX512 static void FillAvx512(T* data, size_t n, T value) noexcept
+    {
+        Avx512::Fill(data, n, value);
+    }
+
+    VECTOR_SIMD_TARGET_AVX2 static size_t FindAvx2(const T* data, size_t n, T value) noexcept
+    {
+        return Avx2::Find(data, n, value);
+    }
+
+    VECTOR_SIMD_TARGET_AVX512 static size_t FindAvx512(const T* data, size_t n, T value) noexcept
+    {
+        return Avx512::Find(data, n, value);
+    }
+
+    VECTOR_SIMD_TARGET_AVX2 static T AccumulateAvx2(const T* data, size_t n, T init) noexcept
+    {
+        return Avx2::Accumulate(data, n, init);
+    }
+
+    VECTOR_SIMD_TARGET_AVX512 static T AccumulateAvx512(const T* data, size_t n, T init) noexcept
+    {
+        return Avx512::Accumulate(data, n, init);
+    }
+
+    template <typename Op>
+    VECTOR_SIMD_TARGET_AVX2 static void TransformAvx2(const T* from, size_t n, T* to, Op& op)
+    {
+        Avx2::Transform(from, n, to, op);
+    }
+
+    template <typename Op>
+    VECTOR_SIMD_TARGET_AVX512 static void TransformAvx512(const T* from, size_t n, T* to, Op& op)
+    {
+        Avx512::Transform(from, n, to, op);
+    }
+
+    template <typename U>
+    VECTOR_SIMD_TARGET_AVX2 static void CopyConvertAvx2(const T* from, size_t n, U* to) noexcept
+    {
+        Avx2::CopyConvert(from, n, to);
+    }
+
+    template <typename U>
+    VECTOR_SIMD_TARGET_AVX512 static void CopyConvertAvx512(const T* from, size_t n, U* to) noexcept
+    {
+        Avx512::CopyConvert(from, n, to);
+    }
+#endif
+};
+
+template <typename T, typename Alloc, typename GrowthPolicy>
+void Fill(Vector<T, Alloc, GrowthPolicy>& v, T value) noexcept
+{
+    VectorSimd<T>::Fill(v.Data(), v.Size(), value);
+}
+
+template <typename T, typename Alloc, typename GrowthPolicy>
+typename Vector<T, Alloc, GrowthPolicy>::iterator Find(Vector<T, Alloc, GrowthPolicy>& v, T value) noexcept
+{
+    return v.begin() + VectorSimd<T>::Find(v.Data(), v.Size(), value);
+}
+
+template <typename T, typename Alloc, typename GrowthPolicy>
+typename Vector<T, Alloc, GrowthPolicy>::const_iterator Find(const Vector<T, Alloc, GrowthPolicy>& v,
+                                                             T value) noexcept
+{
+    return v.begin() + VectorSimd<T>::Find(v.Data(), v.Size(), value);
+}
+
+template <typename T, typename Alloc, typename GrowthPolicy>
+T Accumulate(const Vector<T, Alloc, GrowthPolicy>& v, T init = T{}) noexcept
+{
+    return VectorSimd<T>::Accumulate(v.Data(), v.Size(), init);
+}
+
+// Размер to становится равным размеру from. to может быть тем же вектором, что и from
+template <typename T, typename Alloc, typename GrowthPolicy, typename ToAlloc, typename ToGrowthPolicy, typename Op>
+void Transform(const Vector<T, Alloc, GrowthPolicy>& from, Vector<T, ToAlloc, ToGrowthPolicy>& to, Op op)
+{
+    if (static_cast<const void*>(&from) != static_cast<const void*>(&to))
+    {
+        to.ResizeDefaultInit(from.Size());
+    }
+    VectorSimd<T>::Transform(from.Data(), from.Size(), to.Data(), std::move(op));
+}
+
+template <typename T, typename Alloc, typename GrowthPolicy, typename U, typename ToAlloc, typename ToGrowthPolicy>
+void CopyConvert(const Vector<T, Alloc, GrowthPolicy>& from, Vector<U, ToAlloc, ToGrowthPolicy>& to)
+{
+    to.ResizeDefaultInit(from.Size());
+    VectorSimd<T>::CopyConvert(from.Data(), from.Size(), to.Data());
+}
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+#if __has_include(<version>)
+#include <version>
+#endif
+
+/*
+Необязательная инструментация RawMemory и Vector.
+
+Включается макросом VECTOR_ENABLE_STATS, который нужно определить до подключения
+vector.h (или передать компилятору: -DVECTOR_ENABLE_STATS). Без макроса функции
+VectorStatsRecorder<T> пусты и полностью удаляются компилятором, так что
+инструментация ничего не стоит.
+
+Счётчики ведутся отдельно для каждого типа элементов T:
+-allocations / deallocations / bytes_allocated — обращения RawMemory к аллокатору;
+-growth_events — реаллокации с переносом элементов в новый буфер;
+-shrink_events — переносы элементов в меньший буфер (ShrinkToFit, ShrinkingGrowth);
+-in_place_growths — рост без второго буфера (try_expand / reallocate);
+-moved_elements / copied_elements / relocated_elements — элементы, перенесённые
+ при росте перемещением, копированием (запасной путь для типов с бросающим
+ move-конструктором) и побайтово;
+-peak_capacity — наибольшая вместимость буфера.
+
+Снимок всех зарегистрированных типов возвращает SnapshotAllVectorStats(),
+снимок одного типа — GetVectorStats<T>(). Счётчики атомарны (relaxed), поэтому
+их можно читать во время работы других потоков.
+*/
+
+struct VectorStatsSnapshot
+{
+    const char* type_name = nullptr;
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t bytes_allocated = 0;
+    uint64_t growth_events = 0;
+    uint64_t shrink_events = 0;
+    uint64_t in_place_growths = 0;
+    uint64_t moved_elements = 0;
+    uint64_t copied_elements = 0;
+    uint64_t relocated_elements = 0;
+    uint64_t peak_capacity = 0;
+};
+
+struct VectorStatsCounters
+{
+    VectorStatsSnapshot Snapshot(const char* type_name) const noexcept
+    {
+        VectorStatsSnapshot result;
+        result.type_name = type_name;
+        result.allocations = allocations.load(std::memory_order_relaxed);
+        result.deallocations = deallocations.load(std::memory_order_relaxed);
+        result.bytes_allocated = bytes_allocated.load(std::memory_order_relaxed);
+        result.growth_events = growth_events.load(std::memory_order_relaxed);
+        result.shrink_events = shrink_events.load(std::memory_order_relaxed);
+        result.in_place_growths = in_place_growths.load(std::memory_order_relaxed);
+        result.moved_elements = moved_elements.load(std::memory_order_relaxed);
+        result.copied_elements = copied_elements.load(std::memory_order_relaxed);
+        result.relocated_elements = relocated_elements.load(std::memory_order_relaxed);
+        result.peak_capacity = peak_capacity.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    void Reset() noexcept
+    {
+        for (std::atomic<uint64_t>* counter : { &allocations, &deallocations, &bytes_allocated, &growth_events,
+                                                &shrink_events, &in_place_growths, &moved_elements, &copied_elements,
+                                                &relocated_elements, &peak_capacity })
+        {
+            counter->store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void UpdatePeakCapacity(uint64_t capacity) noexcept
+    {
+        uint64_t peak = peak_capacity.load(std::memory_order_relaxed);
+        while (peak < capacity && !peak_capacity.compare_exchange_weak(peak, capacity, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    std::atomic<uint64_t> allocations{ 0 };
+    std::atomic<uint64_t> deallocations{ 0 };
+    std::atomic<uint64_t> bytes_allocated{ 0 };
+    std::atomic<uint64_t> growth_events{ 0 };
+    std::atomic<uint64_t> shrink_events{ 0 };
+    std::atomic<uint64_t> in_place_growths{ 0 };
+    std::atomic<uint64_t> moved_elements{ 0 };
+    std::atomic<uint64_t> copied_elements{ 0 };
+    std::atomic<uint64_t> relocated_elements{ 0 };
+    std::atomic<uint64_t> peak_capacity{ 0 };
+};
+
+// Реестр счётчиков всех типов, для которых велась статистика
+class VectorStatsRegistry
+{
+public:
+    static VectorStatsRegistry& Instance()
+    {
+        static VectorStatsRegistry registry;
+        return registry;
+    }
+
+    // Вызывается из noexcept-точек записи статистики. Если памяти под запись реестра
+    // не хватило, тип не попадает в SnapshotAllVectorStats, но GetVectorStats<T> работает
+    void Register(const char* type_name, VectorStatsCounters* counters) noexcept
+    {
+        try
+        {
+            std::lock_guard guard(mutex_);
+            entries_.push_back({ type_name, counters });
+        }
+        catch (...)
+        {
+        }
+    }
+
+    std::vector<VectorStatsSnapshot> Snapshot() const
+    {
+        std::lock_guard guard(mutex_);
+        std::vector<VectorStatsSnapshot> result;
+        result.reserve(entries_.size());
+        for (const Entry& entry : entries_)
+        {
+            result.push_back(entry.counters->Snapshot(entry.type_name));
+        }
+        return result;
+    }
+
+    void Reset()
+    {
+        std::lock_guard guard(mutex_);
+        for (const Entry& entry : entries_)
+        {
+            entry.counters->Reset();
+        }
+    }
+
+private:
+    struct Entry
+    {
+        const char* type_name;
+        VectorStatsCounters* counters;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+};
+
+template <typename T>
+VectorStatsCounters& GetVectorStatsCounters()
+{
+    static VectorStatsCounters* counters = []
+    {
+        static VectorStatsCounters instance;
+        VectorStatsRegistry::Instance().Register(typeid(T).name(), &instance);
+        return &instance;
+    }();
+    return *counters;
+}
+
+template <typename T>
+VectorStatsSnapshot GetVectorStats()
+{
+    return GetVectorStatsCounters<T>().Snapshot(typeid(T).name());
+}
+
+inline std::vector<VectorStatsSnapshot> SnapshotAllVectorStats()
+{
+    return VectorStatsRegistry::Instance().Snapshot();
+}
+
+inline void ResetVectorStats()
+{
+    VectorStatsRegistry::Instance().Reset();
+}
+
+// Точки записи статистики, вызываемые из RawMemory и Vector. При вычислениях
+// на этапе компиляции (constexpr Vector в C++20) статистика не ведётся
+template <typename T>
+struct VectorStatsRecorder
+{
+    static constexpr bool IsConstantEvaluated() noexcept
+    {
+#if defined(__cpp_lib_is_constant_evaluated)
+        return std::is_constant_evaluated();
+#else
+        return false;
+#endif
+    }
+
+    static constexpr void OnAllocate([[maybe_unused]] size_t capacity) noexcept
+    {
+#if defined(VECTOR_ENABLE_STATS)
+        if (IsConstantEvaluated())
+        {
+            return;
+        }
+        VectorStatsCounters& counters = GetVectorStatsCounters<T>();
+        counters.allocations.fetch_add(1, std::memory_order_relaxed);
+        counters.bytes_allocated.fetch_add(capacity * sizeof(T), std::memory_order_relaxed);
+        counters.UpdatePeakCapacity(capacity);
+#endif
+    }
+
+    static constexpr void OnDeallocate() noexcept
+    {
+#if defined(VECTOR_ENABLE_STATS)
+        if (IsConstantEvaluated())
+        {
+            return;
+        }
+        GetVectorStatsCounters<T>().deallocations.fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+    static constexpr void OnGrowth() noexcept
+    {
+#if defined(VECTOR_ENABLE_STATS)
+        if (IsConstantEvaluated())
+        {
+            return;
+        }
+        GetVectorStatsCounters<T>().growth_events.fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+    static constexpr void OnShrink() noexcept
+    {
+#if defined(VECTOR_ENABLE_STATS)
+        if (IsConstantEvaluated())
+        {
+            return;
+        }
+        GetVectorStatsCounters<T>().shrink_events.fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+    static constexpr void OnInPlaceGrowth([[maybe_unused]] size_t new_capacity) noexcept
+    {
+#if defined(VECTOR_ENABLE_STATS)
+        if (IsConstantEvaluated())
+        {
+            return;
+        }
+        VectorStatsCounters& counters = GetVectorStatsCounters<T>();
+        counters.in_place_growths.fetch_add(1, std::memory_order_relaxed);
+        counters.UpdatePeakCapacity(new_capacity);
+#endif
+    }
+
+    static constexpr void OnMoved([[maybe_unused]] size_t n) noexcept
+    {
+#if defined(VECTOR_ENABLE_STATS)
+        if (IsConstantEvaluated())
+        {
+            return;
+        }
+        GetVectorStatsCounters<T>().moved_elements.fetch_add(n, std::memory_order_relaxed);
+#endif
+    }
+
+    static constexpr void OnCopied([[maybe_unused]] size_t n) noexcept
+    {
+#if defined(VECTOR_ENABLE_STATS)
+        if (IsConstantEvaluated())
+        {
+            return;
+        }
+        GetVectorStatsCounters<T>().copied_elements.fetch_add(n, std::memory_order_relaxed);
+#endif
+    }
+
+    static constexpr void OnRelocated([[maybe_unused]] size_t n) noexcept
+    {
+#if defined(VECTOR_ENABLE_STATS)
+        if (IsConstantEvaluated())
+        {
+            return;
+        }
+        GetVectorStatsCounters<T>().relocated_elements.fetch_add(n, std::memory_order_relaxed);
+#endif
+    }
+};